@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    Mako_Bench.cpp
+    R1.40 TIER BENCHMARK. See Mako_Bench.h.
+
+  ==============================================================================
+*/
+
+#include "Mako_Bench.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    //R1.40 Bass like test signal. A plucked note every half second (decaying saw plus noise), so the
+    //R1.40 gate opens and closes and the envelope keeps moving like it does on a real track.
+    void Mako_Bench_Signal(double Rate, juce::AudioBuffer<float>& Buf)
+    {
+        const int N = Buf.getNumSamples();
+        const int Note = juce::jmax(1, int(Rate * .5));
+        const float Notes[] = { 41.2f, 55.0f, 73.4f, 98.0f };
+        juce::Random Rand(3);
+
+        float Phase = 0.0f;
+        for (int s = 0; s < N; s++)
+        {
+            int n = s / Note;
+            float t = float(s - n * Note) / float(Rate);
+            Phase += Notes[n % 4] / float(Rate);
+            Phase -= std::floor(Phase);
+
+            float x = std::exp(-t * 6.0f) * (.6f * (2.0f * Phase - 1.0f) + .05f * (Rand.nextFloat() * 2.0f - 1.0f));
+            Buf.setSample(0, s, x);
+            Buf.setSample(1, s, x * .8f);
+        }
+    }
+}
+
+void Mako_Bench_Tiers(const tp_bench_config& Config, tp_bench_result& Result)
+{
+    Result = tp_bench_result();
+    const int Block = juce::jmax(1, Config.BlockSize);
+    const int N = juce::jmax(Block, int(Config.SampleRate * Config.Seconds));
+
+    juce::AudioBuffer<float> Input(2, N), Work(2, N);
+    Mako_Bench_Signal(Config.SampleRate, Input);
+
+    for (int m = 0; m < tp_bench_result::Mode_Count; m++)
+    {
+        for (int Tier = 0; Tier < MakoSmackTalkCore::e_TierCount; Tier++)
+        {
+            double Best = 0.0;
+            for (int Run = 0; Run < juce::jmax(1, Config.Runs); Run++)
+            {
+                //R1.40 The plugin's default knobs, in mode m.
+                auto Core = std::make_unique<MakoSmackTalkCore>();
+                const float Knobs[] = { 1.0f, 0.0f, .3f, .5f, 1.0f, float(m), 0.0f, 2.0f, .75f, float(MakoSmackTalkCore::e_DetectOwn) };
+                for (int k = 0; k < 10; k++) Core->Setting[k] = Knobs[k];
+                Core->Quality = Tier;
+                Core->prepare({ Config.SampleRate, juce::uint32(Block), 2 });
+                Result.Kernels = Core->Kernels->Name;
+
+                for (int channel = 0; channel < 2; channel++) Work.copyFrom(channel, 0, Input, channel, 0, N);
+
+                auto Ticks = juce::Time::getHighResolutionTicks();
+                for (int start = 0; start < N; start += Block)
+                {
+                    float* chans[2] = { Work.getWritePointer(0, start), Work.getWritePointer(1, start) };
+                    Core->process(chans, 2, juce::jmin(Block, N - start));
+                }
+                double ns = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - Ticks) * 1.0e9 / double(N);
+
+                Best = (Run == 0) ? ns : juce::jmin(Best, ns);
+            }
+            Result.Tier_NsPerSample[m][Tier] = Best;
+        }
+    }
+}
+
+void Mako_Bench_Pitch(const tp_pitch_bench_config& Config, tp_pitch_bench_result& Result)
+{
+    Result = tp_pitch_bench_result();
+    const int Block = juce::jmax(1, Config.BlockSize);
+    const int Warm = int(Config.SampleRate);
+    const int N = juce::jmax(Block, int(Config.SampleRate * Config.Seconds));
+
+    //R1.80 The note with its first four harmonics.
+    std::vector<float> In(size_t(Warm + N));
+    for (size_t s = 0; s < In.size(); s++)
+    {
+        double t = double(s) * Config.Note_Hz / Config.SampleRate;
+        float x = 0.0f;
+        for (int h = 1; h <= 4; h++) x += float(std::sin(6.283185307179586 * t * h)) * .4f / float(h);
+        In[s] = x;
+    }
+
+    auto Pitch = std::make_unique<MakoPitch>();
+    Pitch->prepare(Config.SampleRate);
+    for (int start = 0; start < Warm; start += Block) Pitch->process(In.data() + start, juce::jmin(Block, Warm - start));
+
+    std::vector<double> Block_Ns;
+    Block_Ns.reserve(size_t(N / Block + 1));
+    double Total = 0.0;
+    for (int start = Warm; start < Warm + N; start += Block)
+    {
+        auto Ticks = juce::Time::getHighResolutionTicks();
+        Pitch->process(In.data() + start, juce::jmin(Block, Warm + N - start));
+        double ns = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - Ticks) * 1.0e9;
+
+        Block_Ns.push_back(ns);
+        Total += ns;
+    }
+
+    std::sort(Block_Ns.begin(), Block_Ns.end());
+    Result.Avg_NsPerSample = Total / double(N);
+    Result.Median_BlockNs = Block_Ns[Block_Ns.size() / 2];
+    Result.P999_BlockNs = Block_Ns[juce::jmin(Block_Ns.size() - 1, size_t(double(Block_Ns.size()) * .999))];
+    Result.Max_BlockNs = Block_Ns.back();
+    Result.Pitch_Hz = Pitch->Pitch;
+}
@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    Mako_Bench.h
+    R1.40 TIER BENCHMARK. Measures what each QUALITY tier costs, in
+    nanoseconds per (stereo) sample, in every mode, with the kernel set this
+    CPU picks. A fixed bass like test signal is rendered through
+    MakoSmackTalkCore a few times and the fastest run is kept, the slower
+    ones were held up by the OS.
+
+    Call it from a test program (see Tools/MakoBench). It takes a while,
+    never call it from a host.
+
+    R1.80 PITCH BENCHMARK. Times the TRACK pitch detector (Mako_Pitch.h) on
+    its own, one channel, block by block. The check is split over three
+    blocks, so the worst block matters more than the average.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Mako_Core.h"
+
+struct tp_bench_config
+{
+    double SampleRate = 48000.0;
+    int BlockSize = 256;
+    double Seconds = 5.0;               //R1.40 Audio rendered per run.
+    int Runs = 5;                       //R1.40 Runs per measurement. The fastest one counts.
+};
+
+struct tp_bench_result
+{
+    //R1.40 The modes measured, in e_Mode order.
+    static const int Mode_Count = 4;
+
+    juce::String Kernels;               //R1.40 The kernel set that was used.
+    double Tier_NsPerSample[Mode_Count][MakoSmackTalkCore::e_TierCount] = {};
+};
+
+//R1.40 Measure every tier in every mode.
+void Mako_Bench_Tiers(const tp_bench_config& Config, tp_bench_result& Result);
+
+struct tp_pitch_bench_config
+{
+    double SampleRate = 48000.0;
+    int BlockSize = 128;
+    double Seconds = 10.0;              //R1.80 Audio timed. One more second is run first to fill the window.
+    float Note_Hz = 110.0f;             //R1.80 The test note (a few harmonics), so every check runs all its stages.
+};
+
+struct tp_pitch_bench_result
+{
+    double Avg_NsPerSample = 0.0;
+    double Median_BlockNs = 0.0;        //R1.80 A block with no stage of the check in it.
+    double P999_BlockNs = 0.0;          //R1.80 99.9% of blocks were cheaper than this.
+    double Max_BlockNs = 0.0;
+    float Pitch_Hz = 0.0f;              //R1.80 What the detector found, so a fast but broken detector does not pass.
+};
+
+//R1.80 Time the pitch detector.
+void Mako_Bench_Pitch(const tp_pitch_bench_config& Config, tp_pitch_bench_result& Result);
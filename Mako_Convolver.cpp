@@ -0,0 +1,373 @@
+/*
+  ==============================================================================
+
+    Mako_Convolver.cpp
+    R1.70 CAB IR stage. See Mako_Convolver.h.
+
+  ==============================================================================
+*/
+
+#include "Mako_Convolver.h"
+
+MakoConvolver::MakoConvolver()
+{
+    Fft = std::make_unique<juce::dsp::FFT>(Part_Order + 1);
+}
+
+MakoConvolver::~MakoConvolver()
+{
+    delete Pending.exchange(nullptr);
+    delete Retired.exchange(nullptr);
+    delete Cur;
+    delete Old;
+}
+
+void MakoConvolver::prepare(double sampleRate, const tp_kernels* kernels)
+{
+    const juce::ScopedLock sl(Raw_Lock);
+
+    Kernels = kernels;
+    SampleRate = sampleRate;
+    Max_Parts = juce::jmax(1, int(std::ceil(Max_Seconds * SampleRate / double(Part_Size))) - 1);
+
+    In.setSize(2, Fft_Size);
+    Fdl_Re.setSize(2, Max_Parts * Bins);
+    Fdl_Im.setSize(2, Max_Parts * Bins);
+    Tail_Cur.setSize(2, Part_Size);
+    Tail_Old.setSize(2, Part_Size);
+
+    Work.allocate(size_t(Fft_Size * 2), true);
+    Acc_Re.allocate(size_t(Bins), true);
+    Acc_Im.allocate(size_t(Bins), true);
+    Out_Cur.allocate(size_t(Part_Size), true);
+    Out_Old.allocate(size_t(Part_Size), true);
+
+    //R1.70 The audio thread is stopped. Drop anything in flight and rebuild the IR for this sample rate.
+    delete Pending.exchange(nullptr);
+    delete Retired.exchange(nullptr);
+    delete Old;
+    delete Cur;
+    Old = nullptr;
+    Cur = nullptr;
+    Fading = false;
+    Clear_Pending = false;
+
+    if (0 < Raw.getNumSamples()) Cur = Mako_IR_Build(Raw, Raw_Rate);
+
+    reset();
+}
+
+//R1.70 Clear the audio history. The loaded IR is kept.
+void MakoConvolver::reset()
+{
+    In.clear();
+    Fdl_Re.clear();
+    Fdl_Im.clear();
+    Tail_Cur.clear();
+    Tail_Old.clear();
+    Pos = 0;
+    Fdl_Pos = 0;
+    Fdl_Valid = 0;
+}
+
+bool MakoConvolver::LoadIR(const juce::File& file)
+{
+    juce::AudioFormatManager Formats;
+    Formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> Reader(Formats.createReaderFor(file));
+    if ((Reader == nullptr) || (Reader->sampleRate <= 0.0) || (Reader->lengthInSamples < 1)) return false;
+
+    //R1.70 Only read what we can use. A little extra so resampling has the samples it needs.
+    int Len = int(juce::jmin(Reader->lengthInSamples, juce::int64(Max_Seconds * Reader->sampleRate) + 2));
+    juce::AudioBuffer<float> ir(int(juce::jmin(2u, Reader->numChannels)), Len);
+    Reader->read(&ir, 0, Len, 0, true, true);
+
+    if (!LoadIR(ir, Reader->sampleRate)) return false;
+
+    const juce::ScopedLock sl(Raw_Lock);
+    Raw_File = file;
+    return true;
+}
+
+bool MakoConvolver::LoadIR(const juce::AudioBuffer<float>& ir, double irRate)
+{
+    if ((ir.getNumChannels() < 1) || (ir.getNumSamples() < 1) || (irRate <= 0.0)) return false;
+
+    tp_ir* Built = nullptr;
+    {
+        const juce::ScopedLock sl(Raw_Lock);
+        Raw.makeCopyOf(ir);
+        Raw_Rate = irRate;
+        Raw_File = juce::File();
+
+        //R1.70 Not prepared yet. prepare will build it.
+        if (SampleRate <= 0.0) return true;
+        Built = Mako_IR_Build(Raw, Raw_Rate);
+    }
+
+    Mako_Hand_Over(Built);
+    return true;
+}
+
+void MakoConvolver::ClearIR()
+{
+    {
+        const juce::ScopedLock sl(Raw_Lock);
+        Raw.setSize(0, 0);
+        Raw_File = juce::File();
+    }
+
+    delete Retired.exchange(nullptr);
+    delete Pending.exchange(nullptr);
+    Clear_Pending = true;
+}
+
+juce::File MakoConvolver::getFile() const
+{
+    const juce::ScopedLock sl(Raw_Lock);
+    return Raw_File;
+}
+
+//R1.70 Give a new IR to the audio thread. Also clean up whatever the audio thread is done with.
+void MakoConvolver::Mako_Hand_Over(tp_ir* ir)
+{
+    delete Retired.exchange(nullptr);
+    Clear_Pending = false;
+
+    //R1.70 If the audio thread never picked up the last one, it is ours to delete.
+    delete Pending.exchange(ir);
+}
+
+//R1.70 Resample the raw IR to our rate, then split it into the head and the FFT partitions.
+MakoConvolver::tp_ir* MakoConvolver::Mako_IR_Build(const juce::AudioBuffer<float>& raw, double rawRate)
+{
+    double Ratio = rawRate / SampleRate;
+    int Len = int(double(raw.getNumSamples()) / Ratio);
+    Len = juce::jlimit(1, Part_Size * (Max_Parts + 1), Len);
+
+    int Parts = (Len + Part_Size - 1) / Part_Size - 1;
+    juce::AudioBuffer<float> h(2, (Parts + 1) * Part_Size);
+    h.clear();
+
+    for (int channel = 0; channel < 2; channel++)
+    {
+        //R1.70 A mono IR is used on both channels.
+        const float* src = raw.getReadPointer(juce::jmin(channel, raw.getNumChannels() - 1));
+        float* dst = h.getWritePointer(channel);
+
+        //R1.70 Linear interpolation is plenty for a cab IR.
+        for (int s = 0; s < Len; s++)
+        {
+            double p = double(s) * Ratio;
+            int i = int(p);
+            float frac = float(p - double(i));
+            float x0 = (i < raw.getNumSamples()) ? src[i] : 0.0f;
+            float x1 = ((i + 1) < raw.getNumSamples()) ? src[i + 1] : 0.0f;
+            dst[s] = x0 + (x1 - x0) * frac;
+        }
+    }
+
+    //R1.70 IRs come at all levels. Scale so the louder channel has an energy of 1 (about unity gain for a guitar).
+    float Energy = 0.0f;
+    for (int channel = 0; channel < 2; channel++)
+    {
+        const float* src = h.getReadPointer(channel);
+        float e = 0.0f;
+        for (int s = 0; s < Len; s++) e += src[s] * src[s];
+        Energy = juce::jmax(Energy, e);
+    }
+    if (0.0f < Energy) h.applyGain(1.0f / std::sqrt(Energy));
+
+    auto* ir = new tp_ir;
+    ir->Parts = Parts;
+    ir->HeadRev.setSize(2, Part_Size);
+    ir->Re.setSize(2, juce::jmax(1, Parts) * Bins);
+    ir->Im.setSize(2, juce::jmax(1, Parts) * Bins);
+
+    //R1.70 Our own FFT. Fft belongs to the audio thread, and JUCE's FFT can lock while it runs, so sharing it
+    //R1.70 would make the audio thread wait for us.
+    juce::dsp::FFT Build_Fft(Part_Order + 1);
+    std::vector<float> Spec(size_t(Fft_Size * 2));
+    for (int channel = 0; channel < 2; channel++)
+    {
+        const float* src = h.getReadPointer(channel);
+
+        float* head = ir->HeadRev.getWritePointer(channel);
+        for (int t = 0; t < Part_Size; t++) head[t] = src[Part_Size - 1 - t];
+
+        //R1.70 Each partition goes in the first half of the FFT with zeros after it (overlap save).
+        for (int p = 0; p < Parts; p++)
+        {
+            std::fill(Spec.begin(), Spec.end(), 0.0f);
+            std::copy(src + Part_Size * (p + 1), src + Part_Size * (p + 2), Spec.begin());
+            Build_Fft.performRealOnlyForwardTransform(Spec.data(), true);
+
+            float* re = ir->Re.getWritePointer(channel) + p * Bins;
+            float* im = ir->Im.getWritePointer(channel) + p * Bins;
+            for (int k = 0; k < Bins; k++) { re[k] = Spec[size_t(k * 2)]; im[k] = Spec[size_t(k * 2 + 1)]; }
+        }
+    }
+
+    return ir;
+}
+
+//R1.70 A partition of input is full. Put the spectrum of the last two partitions in the delay line.
+void MakoConvolver::Mako_Fdl_Push(int channel, const float* in, int fdlPos)
+{
+    juce::FloatVectorOperations::copy(Work, in, Fft_Size);
+    juce::FloatVectorOperations::clear(Work + Fft_Size, Fft_Size);
+    Fft->performRealOnlyForwardTransform(Work, true);
+
+    float* re = Fdl_Re.getWritePointer(channel) + fdlPos * Bins;
+    float* im = Fdl_Im.getWritePointer(channel) + fdlPos * Bins;
+    for (int k = 0; k < Bins; k++) { re[k] = Work[k * 2]; im[k] = Work[k * 2 + 1]; }
+}
+
+//R1.70 Work out what the FFT partitions add to the next Part_Size output samples.
+void MakoConvolver::Mako_IR_Tail(const tp_ir* ir, int channel, int fdlPos, int fdlValid, float* out)
+{
+    juce::FloatVectorOperations::clear(Acc_Re, Bins);
+    juce::FloatVectorOperations::clear(Acc_Im, Bins);
+
+    //R1.70 Partition p is lined up with the input from p partitions ago.
+    int Parts = juce::jmin(ir->Parts, fdlValid);
+    for (int p = 0; p < Parts; p++)
+    {
+        int slot = (fdlPos - p + Max_Parts) % Max_Parts;
+        Kernels->ComplexMAC(Acc_Re, Acc_Im,
+                            Fdl_Re.getReadPointer(channel) + slot * Bins, Fdl_Im.getReadPointer(channel) + slot * Bins,
+                            ir->Re.getReadPointer(channel) + p * Bins, ir->Im.getReadPointer(channel) + p * Bins, Bins);
+    }
+
+    //R1.70 Back to the time domain. Fill in the negative frequencies (mirror) for the inverse FFT.
+    for (int k = 0; k < Bins; k++) { Work[k * 2] = Acc_Re[k]; Work[k * 2 + 1] = Acc_Im[k]; }
+    for (int k = Bins; k < Fft_Size; k++) { Work[k * 2] = Acc_Re[Fft_Size - k]; Work[k * 2 + 1] = -Acc_Im[Fft_Size - k]; }
+    Fft->performRealOnlyInverseTransform(Work);
+
+    //R1.70 Overlap save. Only the second half is a clean result.
+    juce::FloatVectorOperations::copy(out, Work + Part_Size, Part_Size);
+}
+
+//R1.70 Output of one IR for num samples starting at pos in the partition. No IR = the dry signal.
+void MakoConvolver::Mako_IR_Out(const tp_ir* ir, int channel, const float* in, int pos, const float* tail, float* out, int num)
+{
+    if (ir == nullptr)
+    {
+        juce::FloatVectorOperations::copy(out, in + Part_Size + pos, num);
+        return;
+    }
+
+    //R1.70 HEAD. The first Part_Size taps, direct form, so there is no latency.
+    Kernels->FirBlock(out, in + pos + 1, ir->HeadRev.getReadPointer(channel), num, Part_Size);
+    juce::FloatVectorOperations::add(out, tail + pos, num);
+}
+
+void MakoConvolver::process(float* const* channels, int numChannels, int numSamples)
+{
+    if (Max_Parts < 1) return;
+    if (2 < numChannels) numChannels = 2;
+
+    //R1.70 Pick up a new IR. Only once the last fade is done and the audio thread has nothing waiting to be deleted.
+    if (!Fading && (Retired.load() == nullptr))
+    {
+        bool Swap = false;
+        tp_ir* Next = nullptr;
+
+        //R2.70 Plain loads first. An exchange on every block costs more than a whole 1 sample block.
+        if (Clear_Pending.load() && Clear_Pending.exchange(false))
+            Swap = (Cur != nullptr);
+        else if (Pending.load() != nullptr)
+        {
+            Next = Pending.exchange(nullptr);
+            Swap = (Next != nullptr);
+        }
+
+        if (Swap)
+        {
+            Old = Cur;
+            Cur = Next;
+            Fading = true;
+            Fade_Pos = 0;
+
+            //R1.70 The new IR needs its tail for the partition we are in. The delay line already has the input for it.
+            for (int channel = 0; channel < 2; channel++)
+            {
+                Tail_Old.copyFrom(channel, 0, Tail_Cur, channel, 0, Part_Size);
+                if (Cur != nullptr) Mako_IR_Tail(Cur, channel, Fdl_Pos, Fdl_Valid, Tail_Cur.getWritePointer(channel));
+            }
+        }
+    }
+
+    //R1.70 No IR and no fade. Keep the input history up to date so the next IR starts clean.
+    bool Idle = (Cur == nullptr) && !Fading;
+
+    //R1.70 Every channel moves through the partitions the same way. Keep a copy and save it after the last channel.
+    int pos = Pos, fdlPos = Fdl_Pos, fdlValid = Fdl_Valid, fadePos = Fade_Pos;
+
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        float* data = channels[channel];
+        float* in = In.getWritePointer(channel);
+        pos = Pos; fdlPos = Fdl_Pos; fdlValid = Fdl_Valid; fadePos = Fade_Pos;
+
+        for (int done = 0; done < numSamples; )
+        {
+            int num = juce::jmin(numSamples - done, Part_Size - pos);
+            juce::FloatVectorOperations::copy(in + Part_Size + pos, data + done, num);
+
+            if (!Idle)
+            {
+                Mako_IR_Out(Cur, channel, in, pos, Tail_Cur.getReadPointer(channel), Out_Cur, num);
+
+                //R1.70 Fade from the old IR over Part_Size samples.
+                int nf = Fading ? juce::jmin(num, Part_Size - fadePos) : 0;
+                if (0 < nf)
+                {
+                    Mako_IR_Out(Old, channel, in, pos, Tail_Old.getReadPointer(channel), Out_Old, nf);
+                    for (int s = 0; s < nf; s++)
+                        Out_Cur[s] = Out_Old[s] + (Out_Cur[s] - Out_Old[s]) * (float(fadePos + s + 1) / float(Part_Size));
+                    fadePos += nf;
+                }
+
+                juce::FloatVectorOperations::copy(data + done, Out_Cur, num);
+            }
+
+            pos += num;
+            done += num;
+
+            //R1.70 Partition full. This is the only place the FFTs run, once every Part_Size samples.
+            if (pos == Part_Size)
+            {
+                if (!Idle)
+                {
+                    fdlPos = (fdlPos + 1) % Max_Parts;
+                    Mako_Fdl_Push(channel, in, fdlPos);
+                    fdlValid = juce::jmin(Max_Parts, fdlValid + 1);
+
+                    if (Cur != nullptr) Mako_IR_Tail(Cur, channel, fdlPos, fdlValid, Tail_Cur.getWritePointer(channel));
+                    if ((Old != nullptr) && (fadePos < Part_Size)) Mako_IR_Tail(Old, channel, fdlPos, fdlValid, Tail_Old.getWritePointer(channel));
+                }
+                else
+                    fdlValid = 0;
+
+                juce::FloatVectorOperations::copy(in, in + Part_Size, Part_Size);
+                pos = 0;
+            }
+        }
+    }
+
+    if (numChannels < 1) return;
+    Pos = pos;
+    Fdl_Pos = fdlPos;
+    Fdl_Valid = fdlValid;
+    Fade_Pos = fadePos;
+
+    //R1.70 Fade done. The message thread deletes the old IR next time it loads one.
+    if (Fading && (Part_Size <= Fade_Pos))
+    {
+        Fading = false;
+        if (Old != nullptr) Retired.store(Old);
+        Old = nullptr;
+    }
+}
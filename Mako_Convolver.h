@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    Mako_Convolver.h
+    R1.70 CAB IR stage. Convolves our output with a speaker cabinet impulse
+    response (IR) so a separate cab plugin is not needed.
+
+    Uniformly partitioned convolution with no added latency:
+      - The first Part_Size taps (the HEAD) are a plain FIR, run every sample.
+      - The rest of the IR is split into Part_Size partitions. Each partition is
+        done in the frequency domain (FFT) once every Part_Size samples. Their
+        output is not needed until the next partition, which hides the FFT delay.
+    So the CPU cost is the same every Part_Size samples, however long the IR is.
+
+    IRs are loaded on the message thread and handed to the audio thread with an
+    atomic pointer. The audio thread crossfades from the old IR to the new one.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Mako_Kernels.h"
+
+class MakoConvolver
+{
+public:
+    MakoConvolver();
+    ~MakoConvolver();
+
+    //R1.70 Partition size. Also the length of the direct form head.
+    static const int Part_Order = 6;
+    static const int Part_Size = 1 << Part_Order;
+
+    //R1.70 Longest IR we use (seconds). Longer IRs are cut. Cab IRs are usually 20 to 500ms.
+    const float Max_Seconds = 1.0f;
+
+    //R1.70 Not the audio thread. Sizes everything and rebuilds the loaded IR for the new sample rate.
+    void prepare(double sampleRate, const tp_kernels* kernels);
+    void reset();
+
+    //R1.70 Message thread. Reads a WAV/AIFF file. Returns false if the file could not be read.
+    bool LoadIR(const juce::File& file);
+    bool LoadIR(const juce::AudioBuffer<float>& ir, double irRate);
+
+    //R1.70 Message thread. Fade back to no IR.
+    void ClearIR();
+
+    //R1.70 The file we loaded last (empty if none or if the IR was not from a file).
+    juce::File getFile() const;
+
+    //R1.70 Audio thread. Processes up to 2 channels in place. Does nothing if no IR is loaded.
+    void process(float* const* channels, int numChannels, int numSamples);
+
+private:
+    JUCE_DECLARE_NON_COPYABLE(MakoConvolver)
+
+    static const int Fft_Size = Part_Size * 2;
+    static const int Bins = Part_Size + 1;      //R1.70 Real FFT, only 0 to Nyquist are kept.
+
+    //R1.70 A ready to use IR. Built off the audio thread.
+    struct tp_ir {
+        int Parts = 0;                          //R1.70 Number of FFT partitions after the head.
+        juce::AudioBuffer<float> HeadRev;       //R1.70 2 x Part_Size. First Part_Size taps, backwards (for FirBlock).
+        juce::AudioBuffer<float> Re, Im;        //R1.70 2 x (Parts * Bins). Spectrum of each partition.
+    };
+
+    tp_ir* Mako_IR_Build(const juce::AudioBuffer<float>& raw, double rawRate);
+    void Mako_IR_Tail(const tp_ir* ir, int channel, int fdlPos, int fdlValid, float* out);
+    void Mako_IR_Out(const tp_ir* ir, int channel, const float* in, int pos, const float* tail, float* out, int num);
+    void Mako_Hand_Over(tp_ir* ir);
+    void Mako_Fdl_Push(int channel, const float* in, int fdlPos);
+
+    std::unique_ptr<juce::dsp::FFT> Fft;       //R1.70 Audio thread only. Mako_IR_Build makes its own.
+    const tp_kernels* Kernels = Mako_Kernels_Scalar();
+    double SampleRate = 0.0;
+    int Max_Parts = 0;
+
+    //R1.70 Message thread side. The raw IR is kept so prepare can rebuild it at a new sample rate.
+    juce::CriticalSection Raw_Lock;
+    juce::AudioBuffer<float> Raw;
+    double Raw_Rate = 0.0;
+    juce::File Raw_File;
+
+    //R1.70 Hand over between threads. Pending is a new IR for the audio thread. Retired is an old one to delete.
+    std::atomic<tp_ir*> Pending { nullptr };
+    std::atomic<tp_ir*> Retired { nullptr };
+    std::atomic<bool> Clear_Pending { false };
+
+    //R1.70 Audio thread side. Cur is the IR in use (nullptr = none). Old is the one we are fading from.
+    tp_ir* Cur = nullptr;
+    tp_ir* Old = nullptr;
+    bool Fading = false;
+    int Fade_Pos = 0;
+
+    //R1.70 In holds the last partition and the one being filled (2 x Part_Size). Pos is where we are in it.
+    juce::AudioBuffer<float> In;
+    int Pos = 0;
+
+    //R1.70 FREQUENCY DELAY LINE. The spectrum of the last Max_Parts input partitions, as a ring.
+    juce::AudioBuffer<float> Fdl_Re, Fdl_Im;
+    int Fdl_Pos = 0;
+    int Fdl_Valid = 0;                          //R1.70 How many ring entries hold real audio.
+
+    //R1.70 Tail output (FFT partitions) for the partition being filled.
+    juce::AudioBuffer<float> Tail_Cur, Tail_Old;
+
+    //R1.70 Scratch. Sized in prepare.
+    juce::HeapBlock<float> Work;                //R1.70 FFT in/out, 2 x Fft_Size.
+    juce::HeapBlock<float> Acc_Re, Acc_Im;
+    juce::HeapBlock<float> Out_Cur, Out_Old;
+};
@@ -0,0 +1,1015 @@
+/*
+  ==============================================================================
+
+    Mako_Core.cpp
+    R1.60 The Smack Talk DSP engine. See Mako_Core.h.
+
+  ==============================================================================
+*/
+
+#include "Mako_Core.h"
+#include "cmath"              //R1.00 Added library.
+
+MakoSmackTalkCore::MakoSmackTalkCore()
+{
+}
+
+void MakoSmackTalkCore::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    //R1.00 Get our Sample Rate for filter calculations.
+    SampleRate = float(spec.sampleRate);
+    if (SampleRate <= 0.0f) SampleRate = 48000;
+
+    //R1.50 Decimate the control path at high rates. 88.2/96k = 2, 176.4/192k = 4, 352.8/384k = 8.
+    Rate_Shift = 0;
+    while ((Rate_Shift < 3) && ((72000.0f * float(1 << Rate_Shift)) < SampleRate)) Rate_Shift++;
+    Ctrl_Decim = 1 << Rate_Shift;
+
+    //R1.50 Our envelope was tuned at 48kHz (.005 per sample). Keep the same speed at every sample rate.
+    Env_Coef = 1.0f - std::pow(.995f, 48000.0f * float(Ctrl_Decim) / SampleRate);
+    Ctrl_Rate = 0;
+
+    //R2.70 Coarse envelope decay for every piece length a control segment can have.
+    for (int n = 0; n <= 64 * 8; n++) Env_KeepTab[n] = std::pow(1.0f - Env_Coef, float(n) / float(Ctrl_Decim));
+
+    //R1.20 Pick our DSP kernels for this CPU. Done once here so process never has to check.
+    int Isa = Kernel_Override;
+    if (Isa == e_IsaAuto) Isa = Mako_Kernels_EnvOverride();
+    Kernels = Mako_Kernels_Select(Isa);
+    jassert(Mako_Kernels_SelfTest(Kernels));
+
+    //R1.80 TRACK mode pitch detectors.
+    for (int channel = 0; channel < 2; channel++) Pitch[channel].prepare(SampleRate);
+
+    //R1.70 CAB IR stage. Rebuilds a loaded IR for this sample rate.
+    Cab.prepare(SampleRate, Kernels);
+
+    //R1.20 Size our scratch buffers. Bigger host blocks are processed in chunks of this size.
+    //R2.70 The chunks are fixed MICRO BLOCKS whatever the host block size is. The longest control segment
+    //R2.70 (64 at 48kHz, stretched at high rates) has to fit in one.
+    Micro_Size = 64 * Ctrl_Decim;
+    Scratch_Size = Micro_Size;
+    Scratch.setSize(e_ScrCount, Scratch_Size);
+
+    //R2.50 MODE FADE. 10ms of equal power gains. sin fades the new mode in, cos fades the old one out.
+    Mode_FadeLen = juce::jmax(1, int(SampleRate * .01f));
+    Mode_Gain.setSize(2, Mode_FadeLen);
+    for (int s = 0; s < Mode_FadeLen; s++)
+    {
+        float t = (pi * .5f) * float(s + 1) / float(Mode_FadeLen);
+        Mode_Gain.setSample(0, s, std::sin(t));
+        Mode_Gain.setSample(1, s, std::cos(t));
+    }
+
+    //R1.40 SMACK anti-aliasing. IIR filters keep the latency low. Integer latency lets us line up the dry signal.
+    for (int channel = 0; channel < 2; channel++)
+    {
+        for (int st = 1; st <= OS_MaxStages; st++)
+        {
+            Smack_OS[channel][st] = std::make_unique<juce::dsp::Oversampling<float>>(1, st, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, true);
+            Smack_OS[channel][st]->initProcessing(size_t(Scratch_Size));
+            OS_Latency[st] = int(Smack_OS[channel][st]->getLatencyInSamples());
+        }
+    }
+
+    //R1.40 Our latency is the HIGH tiers latency, whatever tier is used.
+    Dly_Max = OS_Latency[Mako_OS_Stages(e_TierHigh)];
+    int DlySize = juce::nextPowerOfTwo(Scratch_Size + Dly_Max + 1);
+    Dly.setSize(e_DlyCount, DlySize);
+    Dly_Mask = DlySize - 1;
+
+    reset();
+
+    //R1.00 Calculate and pre-Run variables/filters/etc.
+    Mako_Settings_Update(true);
+
+    //R2.80 Start the output gains where the knobs are, so the first block does not ramp in.
+    Mako_Out_Targets(Out_Dry, Out_Wet);
+}
+
+//R1.60 Clear everything that remembers old audio. The settings are kept.
+void MakoSmackTalkCore::reset()
+{
+    Cab.reset();
+    Dly.clear();
+    for (int channel = 0; channel < e_DlyCount; channel++) Dly_Pos[channel] = 0;
+    Env_Phase[0] = 0; Env_Phase[1] = 0;
+
+    //R2.70 Start on a fresh micro block and control segment.
+    Micro_Pos = 0;
+    Seg_Pos = 0;
+    Seg_Force = true;
+
+    //R2.90 Start in the BYPASS state we are set to, no fade.
+    Byp_On = Bypass;
+    Byp_FadePos = -1;
+
+    //R2.50 Start in the mode we are set to, no fade.
+    Mode_Active = int(Setting[e_Mode]);
+    Mode_From = -1;
+    Mode_FadePos = 0;
+
+    for (int channel = 0; channel < 2; channel++)
+    {
+        Signal_AVG[channel] = 0.0f;
+        Pitch[channel].reset();
+        Pedal_NGate_Fac[channel] = 0.0f;
+        for (int st = 1; st <= OS_MaxStages; st++)
+            if (Smack_OS[channel][st] != nullptr) Smack_OS[channel][st]->reset();
+    }
+
+    //R1.60 Filter history only. The coeffs are ramped from where they are.
+    for (int channel = 0; channel < 2; channel++)
+    {
+        makoF_AutoWah[channel].xn1[channel] = 0.0f; makoF_AutoWah[channel].xn2[channel] = 0.0f;
+        makoF_AutoWah[channel].yn1[channel] = 0.0f; makoF_AutoWah[channel].yn2[channel] = 0.0f;
+        makoF_Vox.xn1[channel] = 0.0f; makoF_Vox.xn2[channel] = 0.0f;
+        for (int f = 0; f < Vox_Formants; f++) { makoF_Vox.yn1[channel][f] = 0.0f; makoF_Vox.yn2[channel][f] = 0.0f; }
+    }
+}
+
+//R1.60 juce::dsp wrapper. Processes the output block in place.
+void MakoSmackTalkCore::process(const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    //R1.60 Replacing contexts share one block for in and out.
+    //R2.90 Bypassed still runs, so the latency stays the same and going in and out of bypass is faded.
+    Bypass = context.isBypassed;
+
+    auto& block = context.getOutputBlock();
+    float* chans[2] = {};
+    int numChannels = juce::jmin(2, int(block.getNumChannels()));
+    for (int channel = 0; channel < numChannels; channel++) chans[channel] = block.getChannelPointer(size_t(channel));
+
+    process(chans, numChannels, int(block.getNumSamples()));
+}
+
+void MakoSmackTalkCore::process(float* const* channels, int numChannels, int numSamples, float* const* key, int numKeyChannels)
+{
+    //R1.90 The core can be used without the plugin, so it checks itself too.
+    [[maybe_unused]] MakoRTScope RTCheck;
+
+    //R1.20 Not prepared yet, nothing to do.
+    if (Scratch_Size < 1) return;
+    if (2 < numChannels) numChannels = 2;
+
+    //R2.10 NaN or Inf from the host (or a broken plugin before us) would stick in every filter forever. Zero them.
+    for (int channel = 0; channel < numChannels; ++channel) Mako_Sanitize(channels[channel], numSamples);
+
+    //R2.40 The SIDECHAIN too, it drives our envelope. Only the channels we listen to.
+    if (key == nullptr) numKeyChannels = 0;
+    if (2 < numKeyChannels) numKeyChannels = 2;
+    for (int channel = 0; channel < numKeyChannels; ++channel) Mako_Sanitize(key[channel], numSamples);
+
+    //R1.10 Let the VOX table catch up with Q.
+    if (Setting[e_Q] != Setting_Last[e_Q]) Mako_Settings_Update(false);
+
+    //R1.40 Pick our quality tier. Offline renders can be promoted to HIGH.
+    //R2.70 It is switched to at the start of the next micro block (Mako_Tier_Update).
+    int NewTier = juce::jlimit(0, e_TierCount - 1, Quality);
+    if (ForceHigh) NewTier = e_TierHigh;
+
+    //R1.40 Measure how long this block takes.
+    auto Ticks = juce::Time::getHighResolutionTicks();
+
+    //R1.00 FORCE MONO - Only CHANNEL 0 is processed. It is copied to CHANNEL 1 after.
+    int numProc = (Setting[e_Mono] && (1 < numChannels)) ? 1 : numChannels;
+
+    //R2.90 BYPASS. A change starts a fade. A change during a fade waits for it to finish (10ms), like MODE FADE.
+    if ((Bypass != Byp_On) && (Byp_FadePos < 0))
+    {
+        Byp_On = Bypass;
+        Byp_FadePos = 0;
+        if (!Byp_On) Mako_Bypass_Wake();
+    }
+
+    bool Asleep = Byp_On && (Byp_FadePos < 0);
+    if (Asleep)
+        Mako_Bypass_Block(channels, numChannels, numProc, numSamples, key, numKeyChannels, NewTier);
+    else if (Byp_FadePos < 0)
+        Mako_Process_Block(channels, numChannels, numProc, numSamples, key, numKeyChannels, NewTier);
+    else
+    {
+        //R2.90 Fading. Go one micro block at a time, so each piece's delayed dry is still in the BYPASS ring.
+        int num = 0;
+        for (int start = 0; start < numSamples; start += num)
+        {
+            num = juce::jmin(Micro_Size - Micro_Pos, numSamples - start);
+            float* piece[2] = { channels[0] + start, (1 < numChannels) ? channels[1] + start : nullptr };
+            float* keyPiece[2] = {};
+            for (int channel = 0; channel < numKeyChannels; ++channel) keyPiece[channel] = key[channel] + start;
+
+            Mako_Process_Block(piece, numChannels, numProc, num, keyPiece, numKeyChannels, NewTier);
+            Mako_Bypass_Fade(piece, numChannels, num);
+        }
+    }
+
+    //R2.10 Our filters should never blow up. If they ever do, start clean instead of putting out NaN forever.
+    bool Blown = false;
+    for (int channel = 0; channel < numChannels; ++channel) Blown |= Mako_Sanitize(channels[channel], numSamples);
+    if (Blown) reset();
+
+    //R2.00 Peak output level for TELEMETRY.
+    Peak_Out = 0.0f;
+    for (int channel = 0; (channel < numChannels) && (0 < numSamples); ++channel)
+    {
+        auto r = juce::FloatVectorOperations::findMinAndMax(channels[channel], numSamples);
+        Peak_Out = juce::jmax(Peak_Out, -r.getStart(), r.getEnd());
+    }
+
+    //R1.40 Track the cost of this tier in nanoseconds per sample. Averaged so it does not jump around.
+    //R2.00 Keep the whole block time too.
+    //R2.90 Not while bypassed, that is not what the tier costs.
+    Block_Ns = float(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - Ticks) * 1.0e9);
+    if ((0 < numSamples) && !Asleep)
+    {
+        float ns = Block_Ns / float(numSamples);
+        if (Tier_NsPerSample[Tier] <= 0.0f)
+            Tier_NsPerSample[Tier] = ns;
+        else
+            Tier_NsPerSample[Tier] = (Tier_NsPerSample[Tier] * .99f) + (ns * .01f);
+    }
+}
+
+//R2.90 The whole effect on a block (or one micro block piece of it while BYPASS is fading).
+void MakoSmackTalkCore::Mako_Process_Block(float* const* channels, int numChannels, int numProc, int numSamples, float* const* key, int numKeyChannels, int NewTier)
+{
+    //R1.20 Process the buffer in chunks that fit in our scratch buffers.
+    //R2.40 Every channel of a chunk is done together so LINK and KEY can share one envelope.
+    //R2.70 The chunks are MICRO BLOCKS. Each one runs to the end of the current micro block, so the first one
+    //R2.70 finishes what the last host block started and the last one may stop part way. The same kernels run
+    //R2.70 on the short ones, there is no sample by sample path.
+    int num = 0;
+    for (int start = 0; start < numSamples; start += num)
+    {
+        //R1.40 A tier change is crossfaded over a whole micro block.
+        int FadeFrom = (Micro_Pos == 0) ? Mako_Tier_Update(NewTier) : -1;
+
+        num = juce::jmin(Micro_Size - Micro_Pos, numSamples - start);
+        float* chunk[2] = { channels[0] + start, (1 < numProc) ? channels[1] + start : nullptr };
+
+        //R2.90 Keep the untouched input for BYPASS. Every channel, FORCE MONO or not.
+        for (int channel = 0; channel < numChannels; channel++) Mako_Delay_Write(channels[channel] + start, num, e_DlyByp + channel);
+
+        const float* Key = Mako_Key_Chunk(chunk, numProc, key, numKeyChannels, start, num);
+        Mako_Process_Chunk(chunk, numProc, num, FadeFrom, Key);
+
+        Micro_Pos = (Micro_Pos + num) & (Micro_Size - 1);
+    }
+
+    //R1.00 FORCE MONO - Put CHANNEL 0 data in CHANNEL 1.
+    if (numProc < numChannels) juce::FloatVectorOperations::copy(channels[1], channels[0], numSamples);
+
+    //R1.70 CAB IR. Does nothing if no IR is loaded.
+    Cab.process(channels, numChannels, numSamples);
+
+    //R2.80 OUTPUT SAFETY. Soft clip the whole block to the ceiling, so nothing we put out goes over.
+    if (OutClip)
+    {
+        if (OutCeiling_dB != Out_Ceiling_dB)
+        {
+            Out_Ceiling_dB = OutCeiling_dB;
+            Out_Ceiling = juce::Decibels::decibelsToGain(juce::jlimit(-24.0f, 0.0f, OutCeiling_dB));
+        }
+
+        for (int channel = 0; channel < numChannels; ++channel) Kernels->SoftClip(channels[channel], numSamples, Out_Ceiling);
+    }
+}
+
+//R1.40 Switch to a new quality tier. Returns the tier to crossfade from (-1 for none).
+//R2.70 Only called at the start of a micro block, so a tier change always gets a whole micro block to fade.
+int MakoSmackTalkCore::Mako_Tier_Update(int NewTier)
+{
+    int FadeFrom = -1;
+    if (NewTier != Tier)
+    {
+        //R1.40 Clear out the new tiers oversampler if it has not been running. The first chunk crossfades to it.
+        int st = Mako_OS_Stages(NewTier);
+        if ((0 < st) && (st != Mako_OS_Stages(Tier)))
+            for (int channel = 0; channel < 2; channel++) Smack_OS[channel][st]->reset();
+
+        FadeFrom = Tier;
+        Tier = NewTier;
+    }
+
+    //R1.30 Read our control rate. Changing it mid block is fine, it only sets how often targets update.
+    //R1.50 The rate is in 48kHz samples. Stretch it at high sample rates so updates per second stay the same.
+    //R2.70 A new rate starts a new control segment.
+    int NewRate = Tiers[Tier].CtrlRate;
+    if (NewRate < 1) NewRate = juce::jlimit(1, 64, CtrlRate);
+    NewRate *= Ctrl_Decim;
+    if (NewRate != Ctrl_Rate)
+    {
+        Ctrl_Rate = NewRate;
+        Seg_Pos = 0;
+    }
+
+    return FadeFrom;
+}
+
+//R2.10 Replace NaN and Inf with 0. Returns true if any were found.
+//R2.10 Checks the exponent bits, so it still works with fast math (where isfinite can be optimized away).
+bool MakoSmackTalkCore::Mako_Sanitize(float* data, int num)
+{
+    auto IsBad = [](const float* x)
+    {
+        juce::uint32 Bits;
+        std::memcpy(&Bits, x, sizeof(Bits));
+        return juce::uint32((Bits & 0x7F800000u) == 0x7F800000u);
+    };
+
+    //R2.10 Quick check first. This loop has no branches so it runs fast on clean audio.
+    juce::uint32 Bad = 0;
+    for (int s = 0; s < num; s++) Bad |= IsBad(data + s);
+    if (Bad == 0) return false;
+
+    for (int s = 0; s < num; s++)
+        if (IsBad(data + s)) data[s] = 0.0f;
+    return true;
+}
+
+//R2.40 Find what the envelope listens to for this chunk. nullptr means each channel hears itself.
+//R2.40 A mono key is used right where it is. Only a stereo key or LINK needs the ScrKey row.
+const float* MakoSmackTalkCore::Mako_Key_Chunk(float* const* data, int numChannels, float* const* key, int numKeyChannels, int start, int num)
+{
+    int Detect = int(Setting[e_Detect]);
+    float* out = Scratch.getWritePointer(e_ScrKey);
+
+    if (Detect == e_DetectKey)
+    {
+        //R2.40 No SIDECHAIN connected. Act like it is off.
+        if (numKeyChannels < 1) return nullptr;
+        if (numKeyChannels == 1) return key[0] + start;
+
+        Kernels->KeyLink(out, key[0] + start, key[1] + start, num, true);
+        return out;
+    }
+
+    //R2.40 LINK needs two channels to link.
+    if ((numChannels < 2) || ((Detect != e_DetectLinkMax) && (Detect != e_DetectLinkAvg))) return nullptr;
+
+    Kernels->KeyLink(out, data[0], data[1], num, Detect == e_DetectLinkMax);
+    return out;
+}
+
+//R1.20 Run our effects on a chunk. num is never bigger than Scratch_Size.
+//R2.40 Both channels go through each control segment together. With a shared Key the envelope is tracked once
+//R2.40 and channel 1 reuses the coeffs channel 0 just made.
+void MakoSmackTalkCore::Mako_Process_Chunk(float* const* data, int numChannels, int num, int FadeFrom, const float* Key)
+{
+    float* env[2] = { Scratch.getWritePointer(e_ScrEnv), Scratch.getWritePointer(e_ScrEnvR) };
+    float* wet[2] = { Scratch.getWritePointer(e_ScrWet), Scratch.getWritePointer(e_ScrWetR) };
+    bool UseFX = (.001f <= Setting[e_Mix]);
+    int Mode = int(Setting[e_Mode]);
+    int Segs = 0;
+
+    //R2.50 MODE FADE. A new mode starts fading in at the start of a chunk.
+    //R2.50 A change during a fade waits for that fade to finish (10ms), so the output never jumps.
+    if ((Mode != Mode_Active) && (Mode_From < 0))
+    {
+        Mako_Mode_Start(Mode, Mode_Active);
+        Mode_From = Mode_Active;
+        Mode_FadePos = 0;
+        Mode_Active = Mode;
+    }
+    Mode = Mode_Active;
+
+    //R1.80 TRACK mode. Let the pitch detector hear the raw input. It only reads, so no latency is added.
+    //R2.50 Also while TRACK is fading out.
+    if ((Mode == e_ModeTrack) || (Mode_From == e_ModeTrack))
+        for (int channel = 0; channel < numChannels; channel++) Pitch[channel].process(data[channel], num);
+
+    //R1.30 Split the chunk into control segments. Targets are updated once per segment and ramped across it.
+    //R1.40 First pass: envelope and gate. Save the envelope of each segment for the effects.
+    //R2.70 The segments are on a fixed grid. The first piece finishes the segment the last chunk stopped in.
+    for (int start = 0, pos = Seg_Pos, seg = 0; start < num; start += seg, pos = 0)
+    {
+        seg = juce::jmin(Ctrl_Rate - pos, num - start);
+        Mako_Seg_Piece(pos, seg, Seg_Force && (start == 0));
+
+        //R2.40 LINK or KEY. One envelope for both channels, so the gate and filters move together.
+        if (Key != nullptr)
+        {
+            Mako_Envelope(Key + start, seg, 0);
+            Signal_AVG[1] = Signal_AVG[0];
+            Env_Phase[1] = Env_Phase[0];
+        }
+
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            //R1.00 Always track the envelope because the gate and WAH need it.
+            if (Key == nullptr) Mako_Envelope(data[channel] + start, seg, channel);
+
+            //R1.00 Noise gate.
+            Mako_FX_NoiseGate(data[channel] + start, seg, channel);
+            env[channel][Segs] = Signal_AVG[channel];
+        }
+        Segs++;
+    }
+
+    //R1.40 Line up the dry signal with our reported latency.
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        Mako_Delay_Write(data[channel], num, channel);
+        if (0 < Dly_Max) Mako_Delay_Read(data[channel], num, channel, Dly_Max);
+    }
+
+    //R1.00 Exit if not even using our effects.
+    //R2.50 Nothing of the effect is heard, so there is nothing to fade either.
+    //R2.70 The effect targets were not kept up, so they are made fresh when it comes back.
+    //R2.80 What we put out is the dry signal at full level, so the output gains ramp from there when it comes back.
+    if (!UseFX)
+    {
+        Out_Dry = 1.0f;
+        Out_Wet = 0.0f;
+        Mode_From = -1;
+        Seg_Pos = (Seg_Pos + num) % Ctrl_Rate;
+        Seg_Force = true;
+        return;
+    }
+
+    //R1.00 Apply one of our world famous effects.
+    Mako_Mode_Render(Mode, data, wet, numChannels, num, FadeFrom, false);
+
+    //R2.50 MODE FADE. Render the old mode too, but only for the part of the chunk that is still fading.
+    if (0 <= Mode_From)
+    {
+        float* old[2] = { Scratch.getWritePointer(e_ScrOld), Scratch.getWritePointer(e_ScrOldR) };
+        int n = juce::jmin(num, Mode_FadeLen - Mode_FadePos);
+
+        //R2.50 SMACK reads its delay tap from the END of the chunk, so a shorter render would get the wrong samples.
+        //R2.50 Run it on the whole chunk like the new mode does and only fade the first n.
+        int oldNum = (Mode_From == e_ModeSmack) ? num : n;
+        Mako_Mode_Render(Mode_From, data, old, numChannels, oldNum, FadeFrom, true);
+
+        for (int channel = 0; channel < numChannels; channel++)
+            Kernels->FadeEqualPower(wet[channel], old[channel], Mode_Gain.getReadPointer(0, Mode_FadePos), Mode_Gain.getReadPointer(1, Mode_FadePos), n);
+
+        Mode_FadePos += n;
+        if (Mode_FadeLen <= Mode_FadePos) Mode_From = -1;
+    }
+
+    //R1.00 Volume/Gain adjust and blend the effect with the dry signal.
+    //R2.80 OUTPUT STAGE. Both gains ramp so moving Gain or Mix never clicks. Like the control grid, they get
+    //R2.80 to the knobs at the end of the micro block, so the ramp is the same however the host cuts its blocks.
+    float Dry, Wet;
+    Mako_Out_Targets(Dry, Wet);
+    float Part = float(num) / float(Micro_Size - Micro_Pos);
+    float Dry1 = Out_Dry + ((Dry - Out_Dry) * Part);
+    float Wet1 = Out_Wet + ((Wet - Out_Wet) * Part);
+
+    for (int channel = 0; channel < numChannels; channel++)
+        Kernels->MixDryWet(data[channel], wet[channel], num, Out_Dry, Dry1, Out_Wet, Wet1);
+
+    Out_Dry = Dry1;
+    Out_Wet = Wet1;
+
+    //R2.70 Where the next chunk starts on the control grid.
+    Seg_Pos = (Seg_Pos + num) % Ctrl_Rate;
+    Seg_Force = false;
+}
+
+//R2.80 Where the Mix and Gain knobs want the output gains. EQUAL POWER: dry^2 + wet^2 = 1, so the middle
+//R2.80 of the Mix knob does not dip in level. Gain is only on the effect. Mix 0 and 1 are exact (0 and 1).
+void MakoSmackTalkCore::Mako_Out_Targets(float& Dry, float& Wet)
+{
+    float Mix = juce::jlimit(0.0f, 1.0f, Setting[e_Mix]);
+    Dry = std::sqrt(1.0f - Mix);
+    Wet = std::sqrt(Mix) * Setting[e_Gain];
+}
+
+//R2.50 Render one mode into wet for every channel. data is the delayed, gated input.
+//R2.50 The envelope of each control segment is in the ScrEnv rows (from Mako_Process_Chunk).
+void MakoSmackTalkCore::Mako_Mode_Render(int M, float* const* data, float* const* wet, int numChannels, int num, int FadeFrom, bool Old)
+{
+    if (M == e_ModeSmack)
+    {
+        //R1.40 SMACK has no envelope targets so it runs on the whole chunk (needed for oversampling).
+        for (int channel = 0; channel < numChannels; channel++) Mako_FX_SynthDrive(wet[channel], num, channel, FadeFrom);
+        return;
+    }
+
+    const float* env[2] = { Scratch.getReadPointer(e_ScrEnv), Scratch.getReadPointer(e_ScrEnvR) };
+
+    //R2.50 Fading between TALK and TRACK. The new mode keeps the warm WAH filter, the old one runs on its copy.
+    bool WahFade = Old && ((Mode_Active == e_ModeTalk) || (Mode_Active == e_ModeTrack));
+    tp_filter* wah = WahFade ? makoF_WahOld : makoF_AutoWah;
+    tp_filter* held = WahFade ? Wah_SegOld : Wah_Seg;
+
+    //R2.40 Settings may have changed since the last chunk, so do not trust the saved targets.
+    Wah_Env = -1.0f;
+    Vox_Env = -1.0f;
+
+    //R2.70 The same pieces as the first pass in Mako_Process_Chunk.
+    int Segs = 0;
+    for (int start = 0, pos = Seg_Pos, seg = 0; start < num; start += seg, pos = 0)
+    {
+        seg = juce::jmin(Ctrl_Rate - pos, num - start);
+        Mako_Seg_Piece(pos, seg, Seg_Force && (start == 0));
+
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            if (M == e_ModeVox)
+                Mako_FX_TalkBox(data[channel] + start, wet[channel] + start, seg, channel, env[channel][Segs]);
+            else if (M == e_ModeTrack)
+                Mako_FX_PitchWah(data[channel] + start, wet[channel] + start, seg, channel, env[channel][Segs], &wah[channel], &held[channel]);
+            else
+                Mako_FX_AutoWah(data[channel] + start, wet[channel] + start, seg, channel, env[channel][Segs], &wah[channel], &held[channel]);
+        }
+        Segs++;
+    }
+}
+
+//R2.50 Get mode M ready to fade in. Its filters have not run since it was last used, so their history is old audio.
+//R2.50 Clearing it is cheap and the fade hides the filter starting from silence.
+void MakoSmackTalkCore::Mako_Mode_Start(int M, int From)
+{
+    bool WahFrom = (From == e_ModeTalk) || (From == e_ModeTrack);
+
+    for (int channel = 0; channel < 2; channel++)
+    {
+        if (M == e_ModeSmack)
+        {
+            //R2.50 Start on the SENSE we have now instead of ramping from an old one.
+            Smack_Fac[channel] = 1.0f + (Setting[e_Sense] * 50);
+            Smack_Gain[channel] = 1.5f / Smack_Fac[channel];
+
+            int st = Mako_OS_Stages(Tier);
+            if (0 < st) Smack_OS[channel][st]->reset();
+        }
+        else if (M == e_ModeVox)
+        {
+            makoF_Vox.xn1[channel] = 0.0f; makoF_Vox.xn2[channel] = 0.0f;
+            for (int f = 0; f < Vox_Formants; f++) { makoF_Vox.yn1[channel][f] = 0.0f; makoF_Vox.yn2[channel][f] = 0.0f; }
+        }
+        else
+        {
+            //R2.50 TALK and TRACK share the WAH filter. Between the two it is already warm, so the old mode gets a copy.
+            if (WahFrom)
+            {
+                makoF_WahOld[channel] = makoF_AutoWah[channel];
+                Wah_SegOld[channel] = Wah_Seg[channel];
+            }
+            else
+            {
+                makoF_AutoWah[channel].xn1[channel] = 0.0f; makoF_AutoWah[channel].xn2[channel] = 0.0f;
+                makoF_AutoWah[channel].yn1[channel] = 0.0f; makoF_AutoWah[channel].yn2[channel] = 0.0f;
+            }
+
+            //R2.50 The held pitch is from the last time TRACK was used. Start from the envelope until a new note is found.
+            if (M == e_ModeTrack) Pitch[channel].reset();
+        }
+    }
+
+    //R2.70 Its segment targets are old too. Make new ones on the next piece, even part way through a segment.
+    Seg_Force = true;
+}
+
+//R2.90 BYPASS (after the fade). Only the envelope runs, on the same control grid, so it is warm when we come back.
+//R2.90 The input is put out untouched, delayed by our latency, so the host's delay compensation still lines up.
+void MakoSmackTalkCore::Mako_Bypass_Block(float* const* channels, int numChannels, int numProc, int numSamples, float* const* key, int numKeyChannels, int NewTier)
+{
+    int num = 0;
+    for (int start = 0; start < numSamples; start += num)
+    {
+        //R2.90 Quality and Control Rate changes still happen, so the envelope runs at the right rate.
+        if (Micro_Pos == 0) Mako_Tier_Update(NewTier);
+
+        num = juce::jmin(Micro_Size - Micro_Pos, numSamples - start);
+        float* chunk[2] = { channels[0] + start, (1 < numChannels) ? channels[1] + start : nullptr };
+        const float* Key = Mako_Key_Chunk(chunk, numProc, key, numKeyChannels, start, num);
+
+        for (int s = 0, pos = Seg_Pos, seg = 0; s < num; s += seg, pos = 0)
+        {
+            seg = juce::jmin(Ctrl_Rate - pos, num - s);
+
+            if (Key != nullptr)
+            {
+                Mako_Envelope(Key + s, seg, 0);
+                Signal_AVG[1] = Signal_AVG[0];
+                Env_Phase[1] = Env_Phase[0];
+            }
+            else
+                for (int channel = 0; channel < numProc; channel++) Mako_Envelope(chunk[channel] + s, seg, channel);
+        }
+        Seg_Pos = (Seg_Pos + num) % Ctrl_Rate;
+
+        //R2.90 Both rings get the input. The effect's ring is read by the dry and SMACK taps when we come back.
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            Mako_Delay_Write(chunk[channel], num, channel);
+            Mako_Delay_Write(chunk[channel], num, e_DlyByp + channel);
+            if (0 < Dly_Max) Mako_Delay_Read(chunk[channel], num, e_DlyByp + channel, Dly_Max);
+        }
+
+        Micro_Pos = (Micro_Pos + num) & (Micro_Size - 1);
+    }
+
+    //R2.90 The effect targets and any mode fade are old now.
+    Seg_Force = true;
+    Mode_From = -1;
+}
+
+//R2.90 BYPASS FADE. data has the effect for one micro block piece. Blend it with the delayed untouched input.
+//R2.90 Going into bypass the effect fades out (cos) and the input in (sin), coming out it is the other way.
+void MakoSmackTalkCore::Mako_Bypass_Fade(float* const* data, int numChannels, int num)
+{
+    float* dry = Scratch.getWritePointer(e_ScrByp);
+    int n = (Byp_FadePos < 0) ? 0 : juce::jmin(num, Mode_FadeLen - Byp_FadePos);
+    const float* FadeIn = Mode_Gain.getReadPointer(0, juce::jmax(0, Byp_FadePos));
+    const float* FadeOut = Mode_Gain.getReadPointer(1, juce::jmax(0, Byp_FadePos));
+
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        Mako_Delay_Read(dry, num, e_DlyByp + channel, Dly_Max);
+        if (0 < n)
+        {
+            if (Byp_On)
+                Kernels->FadeEqualPower(data[channel], dry, FadeOut, FadeIn, n);
+            else
+                Kernels->FadeEqualPower(data[channel], dry, FadeIn, FadeOut, n);
+        }
+
+        //R2.90 The fade ended part way through. Going into bypass the rest is the input only.
+        if (Byp_On && (n < num)) juce::FloatVectorOperations::copy(data[channel] + n, dry + n, num - n);
+    }
+
+    if (0 <= Byp_FadePos)
+    {
+        Byp_FadePos += n;
+        if (Mode_FadeLen <= Byp_FadePos) Byp_FadePos = -1;
+    }
+}
+
+//R2.90 Coming out of BYPASS. The effect has not heard anything since it went in, so start its filters and the CAB
+//R2.90 clean instead of playing old history. The envelope was kept running. The fade in covers the restart.
+void MakoSmackTalkCore::Mako_Bypass_Wake()
+{
+    Mako_Mode_Start(Mode_Active, -1);
+    Mode_From = -1;
+    Cab.reset();
+    Mako_Out_Targets(Out_Dry, Out_Wet);
+}
+
+//R1.40 Put a chunk of gated input into our latency ring buffer.
+//R2.90 Channels e_DlyByp on get the untouched input for BYPASS.
+void MakoSmackTalkCore::Mako_Delay_Write(const float* data, int num, int channel)
+{
+    float* ring = Dly.getWritePointer(channel);
+    int pos = Dly_Pos[channel];
+
+    //R2.90 Two straight copies (up to the end of the ring, then from its start) instead of wrapping every sample.
+    int first = juce::jmin(num, Dly_Mask + 1 - pos);
+    juce::FloatVectorOperations::copy(ring + pos, data, first);
+    juce::FloatVectorOperations::copy(ring, data + first, num - first);
+
+    Dly_Pos[channel] = (pos + num) & Dly_Mask;
+}
+
+//R1.40 Read back the chunk we just wrote, delayed by delay samples.
+void MakoSmackTalkCore::Mako_Delay_Read(float* out, int num, int channel, int delay)
+{
+    const float* ring = Dly.getReadPointer(channel);
+    int pos = (Dly_Pos[channel] - num - delay) & Dly_Mask;
+
+    int first = juce::jmin(num, Dly_Mask + 1 - pos);
+    juce::FloatVectorOperations::copy(out, ring + pos, first);
+    juce::FloatVectorOperations::copy(out + first, ring, num - first);
+}
+
+//R1.00 Track our Input Signal Average (Absolute vals). We need this for gate and WAH so always calc.
+//R2.40 Split out of the gate. in is the channel itself, or the shared LINK/KEY input.
+void MakoSmackTalkCore::Mako_Envelope(const float* in, int num, int channel)
+{
+    //R1.50 Env_Coef adjusts it for sample rate.
+    //R1.40 ECO tier only looks at the average of each control segment.
+    if (Tiers[Tier].FineEnv)
+    {
+        //R1.50 Decimated. Only every Ctrl_Decim samples are used, so track where the next one is.
+        int first = Env_Phase[channel];
+        if (first < num)
+        {
+            Signal_AVG[channel] = Kernels->Envelope(in + first, num - first, Signal_AVG[channel], Env_Coef, Ctrl_Decim);
+            first += ((num - first + Ctrl_Decim - 1) / Ctrl_Decim) * Ctrl_Decim;
+        }
+        Env_Phase[channel] = first - num;
+    }
+    else
+    {
+        float KeepN = Env_KeepTab[num];
+        Signal_AVG[channel] = Kernels->EnvelopeCoarse(in, num, Signal_AVG[channel], KeepN);
+    }
+}
+
+//R1.00 Volume envelope based on average Signal volume.
+void MakoSmackTalkCore::Mako_FX_NoiseGate(float* data, int num, int channel)
+{
+    //R1.00 Create a volume envelope based on Signal Average.
+    //R2.70 Once per control segment. Done even with the gate off, so turning it on part way through a segment is right.
+    if (Seg_New)
+    {
+        float Gate = Signal_AVG[channel] * 10000.0f * (1.1f - Setting[e_NGate]);
+
+        //R1.00 Dont amplify the sound, just reduce when necessary.
+        if (1.0f < Gate) Gate = 1.0f;
+        Gate_Seg[channel] = Gate;
+    }
+
+    //R1.00 If not using the Gate, exit out and save a few CPU cycles.
+    if (Setting[e_NGate] < .0001f) return;
+
+    //R1.30 Ramp from the last gate factor to the new one.
+    //R2.70 Only part of the way if this piece does not reach the end of the segment.
+    float Gate = Gate_Seg[channel];
+    if (Seg_Part < 1.0f) Gate = Pedal_NGate_Fac[channel] + (Gate - Pedal_NGate_Fac[channel]) * Seg_Part;
+    Kernels->GateRamp(data, num, Pedal_NGate_Fac[channel], Gate);
+    Pedal_NGate_Fac[channel] = Gate;
+}
+
+//R1.00 Second order parametric/peaking boost filter with constant-Q
+void MakoSmackTalkCore::Filter_BP_Coeffs(float Gain_dB, float Fc, float Q, tp_filter* fn)
+{    
+    float K = pi2 * (Fc * .5f) / SampleRate;
+    float K2 = K * K;
+    float V0 = pow(10.0, Gain_dB / 20.0);
+
+    float a = 1.0f + (V0 * K) / Q + K2;
+    float b = 2.0f * (K2 - 1.0f);
+    float g = 1.0f - (V0 * K) / Q + K2;
+    float d = 1.0f - K / Q + K2;
+    float dd = 1.0f / (1.0f + K / Q + K2);
+
+    fn->a0 = a * dd;
+    fn->a1 = b * dd;
+    fn->a2 = g * dd;
+    fn->b1 = b * dd;
+    fn->b2 = d * dd;
+    fn->c0 = 1.0f;
+    fn->d0 = 0.0f;
+}
+
+//R1.00 Second order LOW PASS filter. 
+void MakoSmackTalkCore::Filter_LP_Coeffs(float fc, tp_filter* fn)
+{    
+    float c = 1.0f / (tanf(pi * fc / SampleRate));
+    fn->a0 = 1.0f / (1.0f + sqrt2 * c + (c * c));
+    fn->a1 = 2.0f * fn->a0;
+    fn->a2 = fn->a0;
+    fn->b1 = 2.0f * fn->a0 * (1.0f - (c * c));
+    fn->b2 = fn->a0 * (1.0f - sqrt2 * c + (c * c));
+}
+
+//F1.00 Second order butterworth High Pass.
+void MakoSmackTalkCore::Filter_HP_Coeffs(float fc, tp_filter* fn)
+{    
+    float c = tanf(pi * fc / SampleRate);
+    fn->a0 = 1.0f / (1.0f + sqrt2 * c + (c * c));
+    fn->a1 = -2.0f * fn->a0;
+    fn->a2 = fn->a0;
+    fn->b1 = 2.0f * fn->a0 * ((c * c) - 1.0f);
+    fn->b2 = fn->a0 * (1.0f - sqrt2 * c + (c * c));
+}
+
+//R1.10 Precalc the VOX formant coeffs for every step of our vowel morph.
+//R1.10 This is expensive so it is only done when the Sample Rate or Q changes.
+void MakoSmackTalkCore::Filter_Bank_Table()
+{
+    //R1.10 Vowel formant frequencies (Hz) and levels. OO -> OH -> AH -> EH -> EE.
+    const float VowelFreq[Vox_Vowels][Vox_Formants] = {
+        { 300.0f,  870.0f, 2240.0f, 3300.0f },  //R1.10 OO
+        { 570.0f,  840.0f, 2410.0f, 3300.0f },  //R1.10 OH
+        { 730.0f, 1090.0f, 2440.0f, 3400.0f },  //R1.10 AH
+        { 530.0f, 1840.0f, 2480.0f, 3500.0f },  //R1.10 EH
+        { 270.0f, 2290.0f, 3010.0f, 3700.0f },  //R1.10 EE
+    };
+    const float VowelLevel[Vox_Formants] = { 1.0f, .6f, .25f, .1f };
+
+    //R1.10 Q knob narrows the formants. More Q = more vowel sound.
+    float Qf = 3.0f + (Setting[e_Q] * 17.0f);
+
+    for (int t = 0; t < Vox_TableSize; t++)
+    {
+        //R1.10 Find the two vowels we are between and how far along we are.
+        float pos = float(t) * float(Vox_Vowels - 1) / float(Vox_TableSize - 1);
+        int v = int(pos);
+        if ((Vox_Vowels - 2) < v) v = Vox_Vowels - 2;
+        float frac = pos - float(v);
+
+        for (int f = 0; f < Vox_Formants; f++)
+        {
+            float Fc = VowelFreq[v][f] + (VowelFreq[v + 1][f] - VowelFreq[v][f]) * frac;
+
+            //R1.10 Keep the formant below Nyquist at low sample rates.
+            if ((SampleRate * .45f) < Fc) Fc = SampleRate * .45f;
+
+            //R1.10 Constant peak gain bandpass.
+            float w0 = pi2 * Fc / SampleRate;
+            float alpha = sinf(w0) / (2.0f * Qf);
+            float dd = 1.0f / (1.0f + alpha);
+
+            //R1.30 The formants are quieter than the dry signal so add some makeup gain (x2).
+            Vox_Table[t].a0[f] = 2.0f * VowelLevel[f] * alpha * dd;
+            Vox_Table[t].b1[f] = -2.0f * cosf(w0) * dd;
+            Vox_Table[t].b2[f] = (1.0f - alpha) * dd;
+        }
+    }
+}
+
+//R1.10 Find the VOX coeffs for a spot (pos) in our vowel table. Blends the two closest table entries.
+void MakoSmackTalkCore::Filter_Bank_Lookup(float pos, tp_bankcoeffs* c)
+{
+    if (pos < 0.0f) pos = 0.0f;
+    if (float(Vox_TableSize - 1) < pos) pos = float(Vox_TableSize - 1);
+    int idx = int(pos);
+    if ((Vox_TableSize - 2) < idx) idx = Vox_TableSize - 2;
+    float frac = pos - float(idx);
+
+    const tp_bankcoeffs* c0 = &Vox_Table[idx];
+    const tp_bankcoeffs* c1 = &Vox_Table[idx + 1];
+    for (int f = 0; f < Vox_Formants; f++)
+    {
+        c->a0[f] = c0->a0[f] + (c1->a0[f] - c0->a0[f]) * frac;
+        c->b1[f] = c0->b1[f] + (c1->b1[f] - c0->b1[f]) * frac;
+        c->b2[f] = c0->b2[f] + (c1->b2[f] - c0->b2[f]) * frac;
+    }
+}
+
+//R1.10 Talk Box effect. Signal_AVG morphs the formant bank between vowels.
+void MakoSmackTalkCore::Mako_FX_TalkBox(const float* data, float* wet, int num, int channel, float Env)
+{
+    //R2.70 New coeffs once per control segment.
+    if (Seg_New)
+    {
+        //R1.10 Same envelope as the WAH so SENSE feels the same in both modes.
+        //R1.10 The WAH envelope tops out at .90, which is the last entry in our vowel table.
+        float tFac = Env * 500.0f * (Setting[e_Sense] * Setting[e_Sense]);
+        if (.90f < tFac) tFac = .90f;
+
+        //R1.10 Get our coeffs from the precalced vowel table. Much cheaper than calcing filters.
+        //R2.40 Same envelope as last time (LINK/KEY channel 1), same coeffs.
+        if (Env != Vox_Env)
+        {
+            Filter_Bank_Lookup(tFac * (float(Vox_TableSize - 1) / .90f), &Vox_Target);
+            Vox_Env = Env;
+        }
+        Vox_Seg[channel] = Vox_Target;
+    }
+
+    //R1.10 Apply our formant bank.
+    //R2.70 A piece that does not reach the end of the segment only ramps part of the way.
+    if (Seg_Part < 1.0f)
+    {
+        const tp_bankcoeffs& c = makoF_Vox.c[channel];
+        const tp_bankcoeffs& t = Vox_Seg[channel];
+        tp_bankcoeffs Part;
+        for (int f = 0; f < Vox_Formants; f++)
+        {
+            Part.a0[f] = c.a0[f] + (t.a0[f] - c.a0[f]) * Seg_Part;
+            Part.b1[f] = c.b1[f] + (t.b1[f] - c.b1[f]) * Seg_Part;
+            Part.b2[f] = c.b2[f] + (t.b2[f] - c.b2[f]) * Seg_Part;
+        }
+        Kernels->VoxBank(wet, data, num, &Part, &makoF_Vox, channel);
+    }
+    else
+        Kernels->VoxBank(wet, data, num, &Vox_Seg[channel], &makoF_Vox, channel);
+}
+
+//R1.00 Create an Envelope Filter based on Signal_AVG value.
+void MakoSmackTalkCore::Mako_FX_AutoWah(const float* data, float* wet, int num, int channel, float Env, tp_filter* fn, tp_filter* target)
+{
+    //R1.00 Adjust the WAH filter. 
+    //R1.30 This is an expensive calculation so it is only done once per control segment.
+    //R1.30 The coeffs are ramped to the new ones across the segment so it does not sound robotic.
+    if (Seg_New)
+    {
+        //R2.00 Envelope Filter.
+        float tFac = Env * 500.0f * (Setting[e_Sense] * Setting[e_Sense]);
+        if (.90f < tFac) tFac = .90f;
+        if (tFac < .0001f) tFac = .0001f;
+
+        //R2.40 Same envelope as last time (LINK/KEY channel 1), same coeffs.
+        if (Env != Wah_Env)
+        {
+            Filter_BP_Coeffs((Setting[e_Q] * 30.0f), 800.0f * (.1f + tFac), 1.4f * (.1f + tFac * 3.0f), &Wah_Target);
+            Wah_Env = Env;
+        }
+        *target = Wah_Target;
+    }
+
+    //R1.00 apply our WAH effect filter.
+    //R2.50 fn is this channel's WAH filter (makoF_AutoWah, or makoF_WahOld while fading out).
+    Mako_Biquad_Piece(wet, data, num, fn, target, channel);
+}
+
+//R2.70 Run a WAH biquad on one piece of a control segment. A piece that does not reach the end of the
+//R2.70 segment only ramps part of the way, so the coeffs land on target at the end of the segment.
+void MakoSmackTalkCore::Mako_Biquad_Piece(float* wet, const float* data, int num, tp_filter* fn, const tp_filter* target, int channel)
+{
+    if (1.0f <= Seg_Part)
+    {
+        Kernels->Biquad(wet, data, num, fn, target, channel);
+        return;
+    }
+
+    tp_filter Part = *target;
+    Part.a0 = fn->a0 + (target->a0 - fn->a0) * Seg_Part;
+    Part.a1 = fn->a1 + (target->a1 - fn->a1) * Seg_Part;
+    Part.a2 = fn->a2 + (target->a2 - fn->a2) * Seg_Part;
+    Part.b1 = fn->b1 + (target->b1 - fn->b1) * Seg_Part;
+    Part.b2 = fn->b2 + (target->b2 - fn->b2) * Seg_Part;
+    Kernels->Biquad(wet, data, num, fn, &Part, channel);
+}
+
+//R1.80 TRACK effect. Same filter as the WAH but the center follows the note being played.
+void MakoSmackTalkCore::Mako_FX_PitchWah(const float* data, float* wet, int num, int channel, float Env, tp_filter* fn, tp_filter* target)
+{
+    //R2.70 New coeffs once per control segment.
+    if (Seg_New)
+    {
+        //R1.80 The envelope still sets the Q and the envelope center, exactly like the WAH.
+        float tFac = Env * 500.0f * (Setting[e_Sense] * Setting[e_Sense]);
+        if (.90f < tFac) tFac = .90f;
+        if (tFac < .0001f) tFac = .0001f;
+        float Fc = 800.0f * (.1f + tFac);
+
+        //R1.80 Blend towards the pitch times Ratio. Track = 0 is the plain WAH, 1 is all pitch.
+        //R1.80 Between notes the last pitch is held, so the filter does not fall back to the envelope.
+        if (0.0f < Pitch[channel].Pitch)
+        {
+            float Fp = Pitch[channel].Pitch * Setting[e_Ratio];
+            Fc += (Fp - Fc) * Setting[e_Track];
+        }
+        Fc = juce::jlimit(40.0f, SampleRate * .45f, Fc);
+
+        Filter_BP_Coeffs((Setting[e_Q] * 30.0f), Fc, 1.4f * (.1f + tFac * 3.0f), target);
+    }
+
+    //R1.80 Shares the WAH filter so switching between TALK and TRACK is smooth.
+    Mako_Biquad_Piece(wet, data, num, fn, target, channel);
+}
+
+void MakoSmackTalkCore::Mako_FX_SynthDrive(float* wet, int num, int channel, int FadeFrom)
+{
+    //R1.00 Apply our Synth effect filter.
+    //R1.00 TFac pushes the frequency of our signal up. We also use it to balance out the gain in volume.
+    float tFac = (1.0f + (Setting[e_Sense] * 50));
+    float tGain = 1.5f / tFac;
+
+    //R1.30 Ramp from the last factor so SENSE changes do not step.
+    Mako_Smack_Render(Tier, wet, num, channel, Smack_Fac[channel], tFac, Smack_Gain[channel], tGain);
+
+    //R1.40 The tier just changed. Render the old tier too and fade from it to the new one.
+    if (0 <= FadeFrom)
+    {
+        float* wet2 = Scratch.getWritePointer(e_ScrWet2);
+        Mako_Smack_Render(FadeFrom, wet2, num, channel, Smack_Fac[channel], tFac, Smack_Gain[channel], tGain);
+        Kernels->Crossfade(wet2, wet, num);
+        juce::FloatVectorOperations::copy(wet, wet2, num);
+    }
+
+    Smack_Fac[channel] = tFac;
+    Smack_Gain[channel] = tGain;
+}
+
+//R1.50 Oversampling stages for a tier. At high sample rates we already have room for the harmonics, so use fewer.
+int MakoSmackTalkCore::Mako_OS_Stages(int T)
+{
+    return juce::jmax(0, Tiers[T].OS_Stages - Rate_Shift);
+}
+
+//R1.40 Render SMACK for one quality tier. Each tier reads the input tap that lines it up with our latency.
+void MakoSmackTalkCore::Mako_Smack_Render(int T, float* wet, int num, int channel, float Fac0, float Fac1, float Gain0, float Gain1)
+{
+    int st = Mako_OS_Stages(T);
+    auto Shape = Tiers[T].FastSine ? Kernels->SineShapeFast : Kernels->SineShape;
+
+    Mako_Delay_Read(wet, num, channel, Dly_Max - OS_Latency[st]);
+
+    //R1.40 No anti-aliasing.
+    if (st == 0)
+    {
+        Shape(wet, wet, num, Fac0, Fac1, Gain0, Gain1);
+        return;
+    }
+
+    //R1.40 Run the sine at 2x or 4x the sample rate so the new harmonics do not fold back down.
+    float* chans[1] = { wet };
+    juce::dsp::AudioBlock<float> block(chans, 1, size_t(num));
+    auto up = Smack_OS[channel][st]->processSamplesUp(block);
+    float* upData = up.getChannelPointer(0);
+    Shape(upData, upData, int(up.getNumSamples()), Fac0, Fac1, Gain0, Gain1);
+    Smack_OS[channel][st]->processSamplesDown(block);
+}
+
+void MakoSmackTalkCore::Mako_Settings_Update(bool ForceAll)
+{
+    //R1.00 We do changes here so we know the vars are not in use while we change them.
+    //R1.60 The plugin copies its Settings in and we make changes here.
+    bool Force = ForceAll;
+
+    //R1.10 The VOX vowel table depends on Q.
+    if (Force || (Setting[e_Q] != Setting_Last[e_Q]))
+    {
+        Filter_Bank_Table();
+        Setting_Last[e_Q] = Setting[e_Q];
+    }
+}
@@ -0,0 +1,273 @@
+/*
+  ==============================================================================
+
+    Mako_Core.h
+    R1.60 The Smack Talk DSP engine. It does not know about plugins or hosts.
+    The plugin (PluginProcessor) is a thin wrapper around it. It can also be
+    used in a juce::dsp::ProcessorChain or in any audio engine that has
+    channel pointers. Audio is processed in place with no copies and no
+    allocations (prepare allocates everything).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Mako_Kernels.h"
+#include "Mako_Convolver.h"
+#include "Mako_Pitch.h"
+#include "Mako_RTCheck.h"
+
+class MakoSmackTalkCore
+{
+public:
+    MakoSmackTalkCore();
+
+    //R1.60 juce::dsp style interface so we can live in a ProcessorChain.
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void process(const juce::dsp::ProcessContextReplacing<float>& context);
+    void reset();
+
+    //R1.60 Process the callers channels in place. Only the first 2 channels are used.
+    //R1.60 numSamples can be any size, bigger blocks than prepare was given are processed in chunks.
+    //R2.70 Every size is cut into the same fixed micro blocks (see Micro_Size), so 1 sample and 8192 sample calls cost the same per sample.
+    //R2.40 key is the SIDECHAIN (1 or 2 channels, numSamples long). It is only listened to when e_Detect is e_DetectKey.
+    void process(float* const* channels, int numChannels, int numSamples, float* const* key = nullptr, int numKeyChannels = 0);
+
+    //R1.60 Latency in samples. Valid after prepare.
+    int getLatencySamples() const { return Dly_Max; }
+
+    //R1.00 These are the indexes into our Settings var.
+    //R1.80 e_Ratio and e_Track have no knobs. They are host parameters for TRACK mode.
+    //R2.40 e_Detect has no knob. It picks what the envelope listens to (e_Detect...).
+    enum { e_Gain, e_NGate, e_Sense, e_Q, e_Mix, e_Mode, e_Mono, e_Ratio, e_Track, e_Detect, };
+
+    //R1.10 The values our e_Mode setting can be.
+    enum { e_ModeSmack, e_ModeTalk, e_ModeVox, e_ModeTrack, };
+
+    //R1.40 QUALITY TIERS.
+    enum { e_TierEco, e_TierStandard, e_TierHigh, e_TierCount, };
+
+    //R2.40 ENVELOPE DETECTION. Each channel hears itself, both channels share one envelope
+    //R2.40 (the louder of L/R, or their average), or the SIDECHAIN key drives both.
+    enum { e_DetectOwn, e_DetectLinkMax, e_DetectLinkAvg, e_DetectKey, };
+
+    //R1.00 Our settings variables. Set them any time between process calls.
+    float Setting[10] = {};
+
+    //R1.60 Controls that are not knobs. Also read at the start of every process call.
+    int Quality = e_TierStandard;   //R1.40 e_Tier...
+    int CtrlRate = 16;              //R1.30 1 to 64 samples (at 48kHz).
+    bool ForceHigh = false;         //R1.40 Use the HIGH tier whatever Quality says (offline renders).
+    bool OutClip = false;           //R2.80 OUTPUT SAFETY soft clipper. Off so old songs sound the same.
+    float OutCeiling_dB = -.3f;     //R2.80 Where the soft clipper stops (dBFS, -24 to 0).
+    bool Bypass = false;            //R2.90 BYPASS. Pass the input through at our latency. Changes are crossfaded.
+
+    //R1.00 Our public variables.
+    float Pedal_NGate_Fac[2] = {};    //R1.00 Noise Gate.
+    float Signal_AVG[2] = {};
+
+    //R1.20 DSP kernels for this CPU. Set Kernel_Override (e_Isa...) before prepare to force a set for A/B testing.
+    //R1.20 If left at e_IsaAuto, the MAKO_SMACKTALK_ISA environment variable is checked.
+    int Kernel_Override = e_IsaAuto;
+    const tp_kernels* Kernels = Mako_Kernels_Scalar();
+
+    //R1.40 The measured cost of each tier (nanoseconds per sample).
+    float Tier_NsPerSample[e_TierCount] = {};
+
+    //R2.00 Stats of the last process call for TELEMETRY. CPU time in nanoseconds and the peak output level.
+    float Block_Ns = 0.0f;
+    float Peak_Out = 0.0f;
+
+    //R1.70 CAB IR stage. Runs last, after the dry/wet mix. Load or clear an IR from the message thread.
+    //R2.80 Only the OUTPUT SAFETY soft clipper comes after it.
+    MakoConvolver Cab;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE(MakoSmackTalkCore)
+
+    float Setting_Last[10] = {};
+
+    //R1.00 Handle changes to our settings.
+    void Mako_Settings_Update(bool ForceAll);
+
+    //R2.10 Zero out NaN and Inf samples. Returns true if there were any.
+    static bool Mako_Sanitize(float* data, int num);
+
+    //R2.90 The whole effect on a block: the micro block chunks, FORCE MONO, CAB and OUTPUT SAFETY.
+    //R2.90 numProc is how many channels the effect runs on (1 in FORCE MONO).
+    void Mako_Process_Block(float* const* channels, int numChannels, int numProc, int numSamples, float* const* key, int numKeyChannels, int NewTier);
+
+    //R1.00 Our actual AUDIO adjusting functions.
+    //R1.20 These work on a chunk of samples. The effects write to wet.
+    //R1.30 The FX functions get one control segment (Ctrl_Rate samples or less) at a time.
+    //R1.40 SMACK works on the whole chunk. FadeFrom is the tier we are crossfading from (-1 for none).
+    //R2.40 A chunk is every channel at once. Key is the shared detector input (nullptr = each channel hears itself).
+    void Mako_Process_Chunk(float* const* data, int numChannels, int num, int FadeFrom, const float* Key);
+    const float* Mako_Key_Chunk(float* const* data, int numChannels, float* const* key, int numKeyChannels, int start, int num);
+    void Mako_Envelope(const float* in, int num, int channel);
+    void Mako_FX_NoiseGate(float* data, int num, int channel);
+    //R2.70 The filter effects get one piece of a control segment. target holds the segment's target (see Seg_New).
+    void Mako_FX_AutoWah(const float* data, float* wet, int num, int channel, float Env, tp_filter* fn, tp_filter* target);
+    void Mako_FX_SynthDrive(float* wet, int num, int channel, int FadeFrom);
+    void Mako_FX_TalkBox(const float* data, float* wet, int num, int channel, float Env);
+    void Mako_FX_PitchWah(const float* data, float* wet, int num, int channel, float Env, tp_filter* fn, tp_filter* target);
+    void Mako_Biquad_Piece(float* wet, const float* data, int num, tp_filter* fn, const tp_filter* target, int channel);
+
+    //R2.50 MODE FADE. Render one mode's wet signal for every channel. Old is true for the mode we are fading out of.
+    void Mako_Mode_Render(int M, float* const* data, float* const* wet, int numChannels, int num, int FadeFrom, bool Old);
+    void Mako_Mode_Start(int M, int From);
+
+    //R1.80 TRACK mode. One pitch detector per channel.
+    MakoPitch Pitch[2];
+
+    //R1.30 CONTROL RATE. Envelope driven targets (filters, gate, Smack) are updated every Ctrl_Rate samples
+    //R1.30 and ramped in between. 1 = every sample (best), 64 = cheapest.
+    int Ctrl_Rate = 16;
+
+    //R1.40 QUALITY TIERS. Each tier picks how every stage is processed.
+    struct tp_tier {
+        int CtrlRate;       //R1.40 0 = use the CtrlRate control.
+        bool FastSine;      //R1.40 SMACK uses a polynomial sine.
+        int OS_Stages;      //R1.40 SMACK anti-aliasing. 0 = none, 1 = 2x, 2 = 4x.
+        bool FineEnv;       //R1.40 Envelope is tracked every sample (true) or once per control segment (false).
+    };
+
+    const tp_tier Tiers[e_TierCount] = {
+        { 64, true,  0, false },    //R1.40 Eco
+        {  0, false, 1, true  },    //R1.40 Standard
+        {  1, false, 2, true  },    //R1.40 High
+    };
+
+    int Tier = e_TierStandard;
+    int Mako_Tier_Update(int NewTier);
+
+    //R1.40 Coarse envelope decay over one control segment.
+    //R2.70 A table by length (0 to 64 x 8 samples), so a short piece never needs a pow().
+    float Env_KeepTab[64 * 8 + 1] = {};
+
+    //R2.70 MICRO BLOCKS. Host buffers are cut into Micro_Size blocks (64 samples at 48kHz, more at high rates so a
+    //R2.70 control segment always fits). The blocks are lined up with the stream, not with the host buffer, so a small
+    //R2.70 host block finishes the micro block the last one started. Nothing is buffered, so there is no extra latency.
+    //R2.70 Micro_Pos is where we are inside the current micro block. Tiers and the control rate only change when it is 0.
+    int Micro_Size = 64;
+    int Micro_Pos = 0;
+
+    //R2.70 CONTROL GRID. Seg_Pos is where the next sample is inside its control segment, carried between host blocks.
+    //R2.70 A segment split over two host blocks is done in pieces. The first piece (Seg_New) makes the targets,
+    //R2.70 every piece ramps Seg_Part of the rest of the way (1 = all of it), so targets are still made once per segment.
+    //R2.70 Seg_Force makes the next piece make new targets (after a mode change or while the effect was off).
+    int Seg_Pos = 0;
+    bool Seg_New = true;
+    float Seg_Part = 1.0f;
+    bool Seg_Force = true;
+    void Mako_Seg_Piece(int pos, int seg, bool Force) { Seg_New = Force || (pos == 0); Seg_Part = float(seg) / float(Ctrl_Rate - pos); }
+
+    //R2.70 The target each channel is ramping to in this segment.
+    float Gate_Seg[2] = {};
+    tp_filter Wah_Seg[2] = {};
+    tp_filter Wah_SegOld[2] = {};
+    tp_bankcoeffs Vox_Seg[2] = {};
+
+    //R1.50 HIGH SAMPLE RATES. The envelope and control path run at about 48kHz whatever the host rate is.
+    //R1.50 Ctrl_Decim is 1, 2, 4 or 8 (2 to the power of Rate_Shift). The audio path always runs at full rate.
+    int Rate_Shift = 0;
+    int Ctrl_Decim = 1;
+    float Env_Coef = .005f;         //R1.50 Envelope coef per decimated step. .005 at 48kHz.
+    int Env_Phase[2] = {};          //R1.50 Where the next decimated envelope sample is in the next segment.
+    int Mako_OS_Stages(int T);
+
+    //R1.40 SMACK anti-aliasing. One oversampler per channel for 2x (1 stage) and 4x (2 stages).
+    static const int OS_MaxStages = 2;
+    std::unique_ptr<juce::dsp::Oversampling<float>> Smack_OS[2][OS_MaxStages + 1];
+    int OS_Latency[OS_MaxStages + 1] = {};
+    void Mako_Smack_Render(int T, float* wet, int num, int channel, float Fac0, float Fac1, float Gain0, float Gain1);
+
+    //R1.40 Every tier and mode is delayed to match the 4x tier so our latency never changes.
+    //R1.40 The gated input goes into a ring buffer. The dry signal and each SMACK tier read their own tap.
+    //R2.90 Channels 0 and 1 are the gated input, e_DlyByp on are the untouched input for BYPASS.
+    enum { e_DlyByp = 2, e_DlyCount = 4, };
+    juce::AudioBuffer<float> Dly;
+    int Dly_Pos[e_DlyCount] = {};
+    int Dly_Mask = 0;
+    int Dly_Max = 0;
+    void Mako_Delay_Write(const float* data, int num, int channel);
+    void Mako_Delay_Read(float* out, int num, int channel, int delay);
+
+    //R2.90 BYPASS. Dly channels e_DlyByp and e_DlyByp + 1 hold the untouched input (the gated one may not be).
+    //R2.90 They are written on every chunk, bypassed or not, so the dry is ready the moment bypass goes on.
+    //R2.90 Byp_On is where we are going. Byp_FadePos counts through the fade (-1 = not fading). Uses Mode_Gain.
+    bool Byp_On = false;
+    int Byp_FadePos = -1;
+    void Mako_Bypass_Block(float* const* channels, int numChannels, int numProc, int numSamples, float* const* key, int numKeyChannels, int NewTier);
+    void Mako_Bypass_Fade(float* const* data, int numChannels, int num);
+    void Mako_Bypass_Wake();
+
+    //R1.20 Scratch buffers for our kernels. Sized in prepare, never in process.
+    //R2.70 One micro block long. 64 floats is a whole number of SIMD vectors, so every row starts aligned.
+    //R1.40 ScrEnv holds the envelope at the end of each control segment.
+    //R2.40 The R rows are for channel 1. ScrKey holds the LINK detector input.
+    //R2.50 ScrOld holds the wet of the mode we are fading out of.
+    //R2.90 ScrByp holds the delayed untouched input during a BYPASS fade.
+    enum { e_ScrEnv, e_ScrEnvR, e_ScrWet, e_ScrWetR, e_ScrWet2, e_ScrKey, e_ScrOld, e_ScrOldR, e_ScrByp, e_ScrCount, };
+    juce::AudioBuffer<float> Scratch;
+    int Scratch_Size = 0;
+
+    //R1.00 Some Constants and vars.
+    const float pi = 3.14159265f;
+    const float pi2 = 6.2831853f;
+    const float sqrt2 = 1.4142135f;
+    float SampleRate = 48000.0f;
+
+    //R1.00 FILTER FUNCTIONS
+    void Filter_BP_Coeffs(float Gain_dB, float Fc, float Q, tp_filter* fn);
+    void Filter_LP_Coeffs(float fc, tp_filter* fn);
+    void Filter_HP_Coeffs(float fc, tp_filter* fn);
+
+    //R1.00 Our pedal filters and function def.
+    //R1.30 One WAH filter per channel. Each channel ramps its own coeffs.
+    tp_filter makoF_AutoWah[2] = {};
+
+    //R2.40 The last WAH and VOX targets and the envelope they were made from. With LINK or KEY both
+    //R2.40 channels have the same envelope, so channel 1 reuses channel 0's coeffs. Cleared every chunk.
+    float Wah_Env = -1.0f;
+    tp_filter Wah_Target = {};
+    float Vox_Env = -1.0f;
+
+    //R2.50 MODE FADE. A mode change fades from the old effect to the new one over Mode_FadeLen samples (10ms).
+    //R2.50 Both effects only run during the fade. Mode_From is the old mode (-1 = not fading).
+    //R2.50 Mode_Gain row 0 fades in (sin), row 1 fades out (cos). Made in prepare.
+    int Mode_Active = e_ModeSmack;
+    int Mode_From = -1;
+    int Mode_FadePos = 0;
+    int Mode_FadeLen = 480;
+    juce::AudioBuffer<float> Mode_Gain;
+
+    //R2.80 OUTPUT STAGE. The dry and wet gains we are at now. They ramp to the knobs by the end of each micro block.
+    float Out_Dry = 1.0f;
+    float Out_Wet = 0.0f;
+    void Mako_Out_Targets(float& Dry, float& Wet);
+
+    //R2.80 OutCeiling_dB as a gain. Only worked out again when it changes.
+    float Out_Ceiling_dB = 0.0f;
+    float Out_Ceiling = 1.0f;
+
+    //R2.50 The WAH filter of the old mode when fading between TALK and TRACK (they share makoF_AutoWah).
+    tp_filter makoF_WahOld[2] = {};
+
+    //R1.30 The SMACK frequency factor and gain each channel is currently using.
+    float Smack_Fac[2] = { 1.0f, 1.0f };
+    float Smack_Gain[2] = { 1.5f, 1.5f };
+
+    //R1.10 VOX (Talk Box) FORMANT BANK. See Mako_Kernels.h.
+    static const int Vox_Vowels = 5;
+    static const int Vox_TableSize = 64;
+
+    void Filter_Bank_Table();
+    void Filter_Bank_Lookup(float pos, tp_bankcoeffs* c);
+
+    tp_bank makoF_Vox = {};
+    tp_bankcoeffs Vox_Table[Vox_TableSize] = {};    //R1.10 Precalced coeffs from OO (0) to EE (Vox_TableSize - 1).
+    tp_bankcoeffs Vox_Target = {};
+};
@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    Mako_EditorBench.cpp
+    R2.30 EDITOR OPEN BENCHMARK. See Mako_EditorBench.h.
+
+  ==============================================================================
+*/
+
+#include "Mako_EditorBench.h"
+
+bool Mako_EditorBench_Run(MakoBiteAudioProcessor& Proc, const tp_editor_bench_config& Config, tp_editor_bench_result& Result)
+{
+    Result = tp_editor_bench_result();
+    const int Opens = juce::jmax(2, Config.Opens);
+
+    double SumConstruct = 0.0, SumPaint = 0.0;
+
+    for (int n = 0; n < Opens; n++)
+    {
+        //R2.30 Construct. This is what the host waits on before it can show the window.
+        double t0 = juce::Time::getMillisecondCounterHiRes();
+        std::unique_ptr<juce::AudioProcessorEditor> Editor(Proc.createEditor());
+        double t1 = juce::Time::getMillisecondCounterHiRes();
+
+        //R2.30 First paint, the whole editor and its knobs, into an image the size of the window.
+        {
+            juce::Image Img(juce::Image::ARGB, juce::jmax(1, Editor->getWidth()), juce::jmax(1, Editor->getHeight()), true);
+            juce::Graphics g(Img);
+            Editor->paintEntireComponent(g, false);
+        }
+        double t2 = juce::Time::getMillisecondCounterHiRes();
+
+        //R2.30 The host deletes the editor when the window closes. Not part of the open time.
+        Editor.reset();
+
+        if (n == 0)
+        {
+            Result.First_Construct_Ms = t1 - t0;
+            Result.First_Paint_Ms = t2 - t1;
+            continue;
+        }
+
+        SumConstruct += t1 - t0;
+        SumPaint += t2 - t1;
+        Result.Max_Ms = juce::jmax(Result.Max_Ms, t2 - t0);
+    }
+
+    Result.Avg_Construct_Ms = SumConstruct / double(Opens - 1);
+    Result.Avg_Paint_Ms = SumPaint / double(Opens - 1);
+    Result.Avg_Ms = Result.Avg_Construct_Ms + Result.Avg_Paint_Ms;
+    Result.Passed = (Result.Max_Ms <= Config.Budget_Ms);
+
+    return Result.Passed;
+}
@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    Mako_EditorBench.h
+    R2.30 EDITOR OPEN BENCHMARK. Times how long it takes to open our editor
+    and draw it for the first time, like a host does when a window is shown.
+    The first open is timed on its own (shared assets are made then), the
+    rest show what every later open costs.
+
+    Painting is done into an offscreen image, so no window is needed.
+    Call it on the message thread, from a test program (see Tools/MakoEditorBench).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+struct tp_editor_bench_config
+{
+    int Opens = 200;                    //R2.30 Editors to build, paint and delete.
+    double Budget_Ms = 10.0;            //R2.30 Worst later open (construct + first paint) allowed.
+};
+
+struct tp_editor_bench_result
+{
+    double First_Construct_Ms = 0.0;    //R2.30 The very first open.
+    double First_Paint_Ms = 0.0;
+
+    double Avg_Construct_Ms = 0.0;      //R2.30 Every open after the first.
+    double Avg_Paint_Ms = 0.0;
+    double Avg_Ms = 0.0;                //R2.30 Construct + first paint.
+    double Max_Ms = 0.0;
+
+    bool Passed = false;
+};
+
+//R2.30 Run the benchmark on a processor. Returns Result.Passed.
+bool Mako_EditorBench_Run(MakoBiteAudioProcessor& Proc, const tp_editor_bench_config& Config, tp_editor_bench_result& Result);
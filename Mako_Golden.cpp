@@ -0,0 +1,366 @@
+/*
+  ==============================================================================
+
+    Mako_Golden.cpp
+    R2.20 GOLDEN RENDER SUITE. See Mako_Golden.h.
+
+  ==============================================================================
+*/
+
+#include "Mako_Golden.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    struct tp_golden_item
+    {
+        juce::String Name;
+        juce::AudioBuffer<float> Audio;
+        juce::AudioBuffer<float> Key;   //R2.20 SIDECHAIN for the KEY case, same length as Audio.
+    };
+
+    const char* const Tier_Names[MakoSmackTalkCore::e_TierCount] = { "Eco", "Standard", "High" };
+
+    //R2.20 One golden case. Every knob (e_Gain to e_Detect) plus the switches that are not knobs.
+    struct tp_golden_case
+    {
+        const char* Name;
+        float Setting[MakoSmackTalkCore::e_Detect + 1];
+        bool Key;                   //R2.20 Feed the SIDECHAIN key signal.
+        bool OutClip;               //R2.20 OUTPUT SAFETY on, at Clip_Ceiling_dB.
+        bool Bypass;                //R2.20 BYPASS for the whole render.
+        int Group;                  //R2.20 Which limits it is held to (e_Golden...).
+    };
+
+    //R2.20 Every mode, every way of detecting, and the output stage. "Talk Mix" is half dry with more Gain, so the
+    //R2.20 dry path and the dry/wet law are checked too. "Talk Clip" has enough Gain to push well into the clipper.
+    //R2.20 VOX, TRACK and LINK use a low Sense. At .6 the envelope pins the filters at the top, so what the envelope
+    //R2.20 hears would hardly matter.
+    const int Smack = MakoSmackTalkCore::e_ModeSmack, Talk = MakoSmackTalkCore::e_ModeTalk;
+    const int Vox = MakoSmackTalkCore::e_ModeVox, Track = MakoSmackTalkCore::e_ModeTrack;
+    const int Own = MakoSmackTalkCore::e_DetectOwn, LinkMax = MakoSmackTalkCore::e_DetectLinkMax;
+    const int LinkAvg = MakoSmackTalkCore::e_DetectLinkAvg, Key = MakoSmackTalkCore::e_DetectKey;
+    const tp_golden_case Cases[] = {
+        { "Smack",         { 1.0f, .3f, .3f,  .5f, 1.0f, float(Smack), 0.0f, 2.0f, .75f, float(Own) },     false, false, false, e_GoldenMain },
+        { "Talk",          { 1.0f, .3f, .6f,  .5f, 1.0f, float(Talk),  0.0f, 2.0f, .75f, float(Own) },     false, false, false, e_GoldenMain },
+        { "Talk Mix",      { 1.5f, .3f, .6f,  .5f, .5f,  float(Talk),  0.0f, 2.0f, .75f, float(Own) },     false, false, false, e_GoldenMain },
+        { "Vox",           { 1.0f, .3f, .1f,  .5f, 1.0f, float(Vox),   0.0f, 2.0f, .75f, float(Own) },     false, false, false, e_GoldenVox },
+        { "Track",         { 1.0f, .3f, .1f,  .5f, 1.0f, float(Track), 0.0f, 2.0f, .75f, float(Own) },     false, false, false, e_GoldenTrack },
+        { "Talk Link Max", { 1.0f, .3f, .05f, .5f, 1.0f, float(Talk),  0.0f, 2.0f, .75f, float(LinkMax) }, false, false, false, e_GoldenMain },
+        { "Talk Link Avg", { 1.0f, .3f, .05f, .5f, 1.0f, float(Talk),  0.0f, 2.0f, .75f, float(LinkAvg) }, false, false, false, e_GoldenMain },
+        { "Talk Key",      { 1.0f, .3f, .6f,  .5f, 1.0f, float(Talk),  0.0f, 2.0f, .75f, float(Key) },     true,  false, false, e_GoldenKey },
+        { "Talk Clip",     { 4.0f, .3f, .6f,  .5f, 1.0f, float(Talk),  0.0f, 2.0f, .75f, float(Own) },     false, true,  false, e_GoldenMain },
+        { "Bypass",        { 1.0f, .3f, .6f,  .5f, 1.0f, float(Talk),  0.0f, 2.0f, .75f, float(Own) },     false, false, true,  e_GoldenMain },
+    };
+    const int Case_Count = int(sizeof(Cases) / sizeof(Cases[0]));
+    const float Clip_Ceiling_dB = -6.0f;
+
+    //R2.20 Long term spectrum FFT.
+    const int Spec_Order = 11;
+    const int Spec_Size = 1 << Spec_Order;
+
+    //R2.20 Build the fixed corpus. Everything is made from fixed seeds so every run is the same.
+    void Mako_Golden_Corpus(double Rate, const juce::Array<juce::File>& Files, std::vector<tp_golden_item>& Items)
+    {
+        //R2.20 Log sine sweep, 20Hz to 20kHz in 4 seconds, -6dB.
+        {
+            tp_golden_item Item { "sweep", juce::AudioBuffer<float>(2, int(Rate * 4.0)) };
+            const int N = Item.Audio.getNumSamples();
+            const double f0 = 20.0, f1 = juce::jmin(20000.0, Rate * .45), T = double(N) / Rate;
+            const double k = std::log(f1 / f0);
+            for (int s = 0; s < N; s++)
+            {
+                double t = double(s) / Rate;
+                float x = .5f * float(std::sin(6.283185307179586 * f0 * T / k * (std::exp(t / T * k) - 1.0)));
+                Item.Audio.setSample(0, s, x);
+                Item.Audio.setSample(1, s, x * .7f);
+            }
+            Items.push_back(std::move(Item));
+        }
+
+        //R2.20 Plucked bass notes (Karplus-Strong string). E1, A1, D2, G2, one second each.
+        {
+            const double Notes[] = { 41.2, 55.0, 73.4, 98.0 };
+            const int Len = int(Rate);
+            tp_golden_item Item { "bass pluck", juce::AudioBuffer<float>(2, Len * 4) };
+            juce::Random Rand(1);
+            std::vector<float> Str;
+
+            for (int n = 0; n < 4; n++)
+            {
+                Str.assign(size_t(juce::jmax(2, int(Rate / Notes[n]))), 0.0f);
+                float lp = 0.0f;
+                for (auto& v : Str) { lp += ((Rand.nextFloat() * 2.0f - 1.0f) - lp) * .5f; v = lp; }
+
+                size_t pos = 0;
+                for (int s = 0; s < Len; s++)
+                {
+                    size_t next = (pos + 1) % Str.size();
+                    float x = Str[pos];
+                    Str[pos] = .5f * (Str[pos] + Str[next]) * .996f;
+                    pos = next;
+
+                    Item.Audio.setSample(0, n * Len + s, .8f * x);
+                    Item.Audio.setSample(1, n * Len + s, .6f * x);
+                }
+            }
+            Items.push_back(std::move(Item));
+        }
+
+        //R2.20 Noise bursts from -48dB to full scale with silence between. Works the gate hard.
+        {
+            const int Burst = int(Rate * .1), Gap = int(Rate * .2);
+            tp_golden_item Item { "noise bursts", juce::AudioBuffer<float>(2, 9 * (Burst + Gap)) };
+            Item.Audio.clear();
+            juce::Random Rand(2);
+
+            for (int b = 0; b < 9; b++)
+            {
+                float Level = std::pow(10.0f, float(-48 + 6 * b) / 20.0f);
+                for (int s = 0; s < Burst; s++)
+                    for (int channel = 0; channel < 2; channel++)
+                        Item.Audio.setSample(channel, b * (Burst + Gap) + Gap + s, Level * (Rand.nextFloat() * 2.0f - 1.0f));
+            }
+            Items.push_back(std::move(Item));
+        }
+
+        //R2.20 User files.
+        juce::AudioFormatManager Formats;
+        Formats.registerBasicFormats();
+        for (const auto& f : Files)
+        {
+            std::unique_ptr<juce::AudioFormatReader> Reader(Formats.createReaderFor(f));
+            if (Reader == nullptr) continue;
+
+            tp_golden_item Item { f.getFileName(), juce::AudioBuffer<float>(2, int(Reader->lengthInSamples)) };
+            Reader->read(&Item.Audio, 0, Item.Audio.getNumSamples(), 0, true, true);
+            Items.push_back(std::move(Item));
+        }
+
+        //R2.20 The SIDECHAIN key for every item. Noise that is on for 1/8 second and off for 1/8 second, louder on the
+        //R2.20 left. It has nothing to do with the item, so the gate and filters are clearly driven by the key.
+        juce::Random Rand(4);
+        const int Half = juce::jmax(1, int(Rate * .125));
+        for (auto& Item : Items)
+        {
+            Item.Key.setSize(2, Item.Audio.getNumSamples());
+            for (int s = 0; s < Item.Key.getNumSamples(); s++)
+            {
+                float x = (((s / Half) & 1) == 0) ? .5f * (Rand.nextFloat() * 2.0f - 1.0f) : 0.0f;
+                Item.Key.setSample(0, s, x);
+                Item.Key.setSample(1, s, x * .5f);
+            }
+        }
+    }
+
+    //R2.20 Copy In to Out with Latency samples of silence on the end, so the delayed tail comes out too.
+    void Mako_Golden_Pad(const juce::AudioBuffer<float>& In, juce::AudioBuffer<float>& Out, int Latency)
+    {
+        const int N = In.getNumSamples();
+        Out.setSize(2, N + Latency);
+        Out.clear();
+        for (int channel = 0; channel < 2; channel++) Out.copyFrom(channel, 0, In, channel, 0, N);
+    }
+
+    //R2.20 Render a padded buffer in place, Block samples at a time. Works for the core and the reference. Returns seconds.
+    //R2.20 Key is the padded SIDECHAIN (nullptr for none).
+    template <typename T>
+    double Mako_Golden_Render(T& Chain, juce::AudioBuffer<float>& Buf, juce::AudioBuffer<float>* Key, int Block)
+    {
+        const int N = Buf.getNumSamples();
+
+        auto Ticks = juce::Time::getHighResolutionTicks();
+        for (int start = 0; start < N; start += Block)
+        {
+            int num = juce::jmin(Block, N - start);
+            float* chans[2] = { Buf.getWritePointer(0, start), Buf.getWritePointer(1, start) };
+            if (Key != nullptr)
+            {
+                float* keys[2] = { Key->getWritePointer(0, start), Key->getWritePointer(1, start) };
+                Chain.process(chans, 2, num, keys, 2);
+            }
+            else
+                Chain.process(chans, 2, num);
+        }
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - Ticks);
+    }
+
+    //R2.20 Long term power spectrum of a channel, added into Pow (Spec_Size / 2 + 1 bins).
+    void Mako_Golden_Spectrum(juce::dsp::FFT& Fft, const float* x, int N, std::vector<double>& Pow)
+    {
+        std::vector<float> Work(size_t(Spec_Size * 2));
+        for (int start = 0; (start + Spec_Size) <= N; start += Spec_Size / 2)
+        {
+            for (int s = 0; s < Spec_Size; s++)
+            {
+                float w = .5f - .5f * std::cos(6.2831853f * float(s) / float(Spec_Size));
+                Work[size_t(s)] = x[start + s] * w;
+            }
+            std::fill(Work.begin() + Spec_Size, Work.end(), 0.0f);
+            Fft.performFrequencyOnlyForwardTransform(Work.data());
+
+            for (int k = 0; k <= Spec_Size / 2; k++) Pow[size_t(k)] += double(Work[size_t(k)]) * double(Work[size_t(k)]);
+        }
+    }
+
+    //R2.20 Compare a path against the reference. Both are read from Offset on (the latency), so the input lines up.
+    void Mako_Golden_Compare(const juce::AudioBuffer<float>& Ref, const juce::AudioBuffer<float>& Test, int Offset, double Rate,
+                             double& MaxAbs, double& Null_dB, double& Spectral_dB)
+    {
+        const int N = Ref.getNumSamples() - Offset;
+        juce::dsp::FFT Fft(Spec_Order);
+        std::vector<double> PowRef(size_t(Spec_Size / 2 + 1)), PowTest(PowRef.size());
+        std::vector<float> Aligned(size_t(N), 0.0f);
+
+        double ErrSum = 0.0, RefSum = 0.0;
+        MaxAbs = 0.0;
+
+        for (int channel = 0; channel < 2; channel++)
+        {
+            const float* r = Ref.getReadPointer(channel) + Offset;
+            const float* t = Test.getReadPointer(channel) + Offset;
+
+            for (int s = 0; s < N; s++)
+            {
+                double e = double(t[s]) - double(r[s]);
+                MaxAbs = juce::jmax(MaxAbs, std::abs(e));
+                ErrSum += e * e;
+                RefSum += double(r[s]) * double(r[s]);
+                Aligned[size_t(s)] = t[s];
+            }
+
+            Mako_Golden_Spectrum(Fft, r, N, PowRef);
+            Mako_Golden_Spectrum(Fft, Aligned.data(), N, PowTest);
+        }
+
+        Null_dB = (0.0 < RefSum) ? 10.0 * std::log10(juce::jmax(1.0e-30, ErrSum / RefSum)) : -300.0;
+
+        //R2.20 Average dB difference over the bins that matter: 20Hz up, and not more than 60dB under the loudest bin.
+        double PeakPow = 0.0;
+        for (double p : PowRef) PeakPow = juce::jmax(PeakPow, p);
+
+        double Sum = 0.0;
+        int Count = 0;
+        for (size_t k = 1; k < PowRef.size(); k++)
+        {
+            double f = double(k) * Rate / double(Spec_Size);
+            if ((f < 20.0) || (PowRef[k] < PeakPow * 1.0e-6)) continue;
+            Sum += std::abs(10.0 * std::log10((PowTest[k] + 1.0e-30) / (PowRef[k] + 1.0e-30)));
+            Count++;
+        }
+        Spectral_dB = (0 < Count) ? Sum / double(Count) : 0.0;
+    }
+}
+
+bool Mako_Golden_Run(const tp_golden_config& Config, tp_golden_result& Result)
+{
+    Result = tp_golden_result();
+    const int Block = juce::jmax(1, Config.BlockSize);
+
+    std::vector<tp_golden_item> Items;
+    Mako_Golden_Corpus(Config.SampleRate, Config.Files, Items);
+
+    //R2.20 The core reports the same latency in every tier, so one prepared core tells us the reference lookahead.
+    int Latency;
+    {
+        MakoSmackTalkCore Core;
+        Core.prepare({ Config.SampleRate, juce::uint32(Block), 2 });
+        Latency = Core.getLatencySamples();
+    }
+
+    //R2.20 Render the reference once per case and item. It gets the same block of silence first as the core does (below).
+    std::vector<juce::AudioBuffer<float>> RefOut(size_t(Case_Count) * Items.size());
+    double RefTime[Case_Count] = {};
+    juce::AudioBuffer<float> Out, KeyBuf, Silence(2, Block);
+
+    for (int c = 0; c < Case_Count; c++)
+    {
+        const tp_golden_case& Case = Cases[c];
+        for (size_t i = 0; i < Items.size(); i++)
+        {
+            MakoReferenceChain Ref;
+            for (int k = 0; k <= MakoSmackTalkCore::e_Detect; k++) Ref.Setting[k] = Case.Setting[k];
+            Ref.OutClip = Case.OutClip;
+            Ref.OutCeiling_dB = Clip_Ceiling_dB;
+            Ref.Bypass = Case.Bypass;
+            Ref.prepare(Config.SampleRate, Latency);
+
+            Silence.clear();
+            Mako_Golden_Render(Ref, Silence, nullptr, Block);
+
+            auto& RefBuf = RefOut[size_t(c) * Items.size() + i];
+            Mako_Golden_Pad(Items[i].Audio, RefBuf, Latency);
+            Mako_Golden_Pad(Items[i].Key, KeyBuf, Latency);
+            RefTime[c] += Mako_Golden_Render(Ref, RefBuf, Case.Key ? &KeyBuf : nullptr, Block);
+        }
+    }
+
+    //R2.20 Every kernel set the CPU can run. A set that falls back to one we already tested is skipped.
+    std::vector<const tp_kernels*> Seen;
+
+    for (int Isa = e_IsaScalar; Isa < e_IsaCount; Isa++)
+    {
+        const tp_kernels* k = Mako_Kernels_Select(Isa);
+        if (std::find(Seen.begin(), Seen.end(), k) != Seen.end()) continue;
+        Seen.push_back(k);
+
+        for (int Tier = 0; Tier < MakoSmackTalkCore::e_TierCount; Tier++)
+        {
+            for (int c = 0; c < Case_Count; c++)
+            {
+                const tp_golden_case& Case = Cases[c];
+                tp_golden_path p;
+                p.Name = juce::String(k->Name) + " " + Tier_Names[Tier] + " " + Case.Name;
+                p.Tier = Tier;
+                p.Mode = int(Case.Setting[MakoSmackTalkCore::e_Mode]);
+                p.Group = Case.Group;
+                p.Spectrum_Only = (p.Mode == MakoSmackTalkCore::e_ModeSmack) && (Tier != MakoSmackTalkCore::e_TierEco) && !Case.Bypass;
+
+                double Time = 0.0;
+                for (size_t i = 0; i < Items.size(); i++)
+                {
+                    //R2.20 A fresh core for every item so nothing carries over.
+                    auto Core = std::make_unique<MakoSmackTalkCore>();
+                    Core->Kernel_Override = Isa;
+                    Core->Quality = Tier;
+                    for (int s = 0; s <= MakoSmackTalkCore::e_Detect; s++) Core->Setting[s] = Case.Setting[s];
+                    Core->OutClip = Case.OutClip;
+                    Core->OutCeiling_dB = Clip_Ceiling_dB;
+                    Core->Bypass = Case.Bypass;
+                    Core->prepare({ Config.SampleRate, juce::uint32(Block), 2 });
+
+                    //R2.20 One block of silence first. A new core ramps SMACK in from its default factor, the reference does not.
+                    Silence.clear();
+                    Mako_Golden_Render(*Core, Silence, nullptr, Block);
+
+                    Mako_Golden_Pad(Items[i].Audio, Out, Latency);
+                    Mako_Golden_Pad(Items[i].Key, KeyBuf, Latency);
+                    Time += Mako_Golden_Render(*Core, Out, Case.Key ? &KeyBuf : nullptr, Block);
+
+                    double MaxAbs, Null_dB, Spectral_dB;
+                    Mako_Golden_Compare(RefOut[size_t(c) * Items.size() + i], Out, Latency, Config.SampleRate, MaxAbs, Null_dB, Spectral_dB);
+
+                    p.MaxAbs = juce::jmax(p.MaxAbs, MaxAbs);
+                    p.Spectral_dB = juce::jmax(p.Spectral_dB, Spectral_dB);
+                    if (p.Null_dB < Null_dB)
+                    {
+                        p.Null_dB = Null_dB;
+                        p.Worst_Item = Items[i].Name;
+                    }
+                }
+                p.Speedup = (0.0 < Time) ? RefTime[c] / Time : 0.0;
+
+                const tp_golden_tolerance& t = Config.Tolerance[Case.Group][Tier];
+                if (p.Spectrum_Only)
+                    p.Passed = (p.Spectral_dB <= Config.Smack_OS_Spectral_dB);
+                else
+                    p.Passed = ((t.MaxAbs < 0.0) || (p.MaxAbs <= t.MaxAbs)) && (p.Null_dB <= t.Null_dB) && (p.Spectral_dB <= t.Spectral_dB);
+
+                Result.Paths.push_back(p);
+            }
+        }
+    }
+
+    return Result.Passed();
+}
@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+    Mako_Golden.h
+    R2.20 GOLDEN RENDER SUITE. Proves that optimizing the DSP did not change
+    the sound. A fixed test corpus (sine sweep, plucked bass notes, noise
+    bursts, plus any files you add) is rendered through the FROZEN REFERENCE
+    (Mako_Reference.h) and through MakoSmackTalkCore with every kernel set
+    this CPU can run and every quality tier. The cases cover every mode
+    (SMACK, TALK, VOX, TRACK), TALK at half Mix, LINK (max and average),
+    KEY with a sidechain signal, the OUTPUT SAFETY soft clipper and BYPASS.
+
+    Each path is compared to the reference by:
+      - Max abs error      biggest single sample difference.
+      - Null depth         level of (path - reference) against the reference, in dB.
+                           -60 means the difference is 60dB down.
+      - Spectral diff      average dB difference of the long term spectra.
+    and reports how much faster than the reference it ran.
+
+    SMACK in STANDARD and HIGH is anti-aliased (oversampled), so it is not
+    meant to null with the 1x reference. Only its spectrum is checked.
+
+    Call Mako_Golden_Run() from a test program (see Tools/MakoGolden).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Mako_Core.h"
+#include "Mako_Reference.h"
+
+//R2.20 How far a path may be from the reference and still pass.
+//R2.20 MaxAbs below 0 means it is not checked (see ECO and STANDARD below).
+struct tp_golden_tolerance
+{
+    double MaxAbs;
+    double Null_dB;
+    double Spectral_dB;
+};
+
+//R2.20 Cases that share limits. VOX, TRACK and KEY land further from the reference than the rest in ECO and
+//R2.20 STANDARD, so they get their own. Main is SMACK (ECO), TALK, LINK, the soft clipper and BYPASS.
+enum { e_GoldenMain, e_GoldenVox, e_GoldenTrack, e_GoldenKey, e_GoldenGroupCount, };
+
+struct tp_golden_config
+{
+    double SampleRate = 48000.0;
+    int BlockSize = 256;
+
+    //R2.20 Extra test files (WAV/AIFF), for example real bass recordings. Used at their own length.
+    juce::Array<juce::File> Files;
+
+    //R2.20 Per group and tier (e_TierEco, e_TierStandard, e_TierHigh). ECO and the control rate trade accuracy for speed
+    //R2.20 on purpose. ECO and STANDARD move the gate and filters once per control segment, so a burst attack can be far
+    //R2.20 off for a few samples while the null and spectrum stay close. That max abs is as big as the signal itself, so
+    //R2.20 it tells us nothing and is not checked there. HIGH must match the reference.
+    //R2.20 PROVISIONAL. Each limit is the worst value seen plus a small margin, but they were taken with a stand-in for
+    //R2.20 the JUCE modules, not a real JUCE build (48kHz, 256 sample blocks). Outside SMACK the DSP only uses JUCE for
+    //R2.20 copies and the pitch FFT, which the core and reference share, so these should hold. Run Tools/MakoGolden on a
+    //R2.20 real JUCE build and set them from its numbers before they gate a release. Seen (worst null / spectrum):
+    //R2.20   Main   Eco -18.7dB / .094dB, Standard -30.0dB / .042dB, High -86.6dB / .000dB (max abs .00062)
+    //R2.20   Vox    Eco -16.8dB / .119dB, Standard -23.7dB / .051dB, High -74.8dB / .000dB (max abs .00030)
+    //R2.20   Track  Eco -16.5dB / .092dB, Standard -18.7dB / .042dB, High -89.7dB / .000dB (max abs .00012)
+    //R2.20   Key    Eco -26.8dB / 2.05dB, Standard -31.5dB / .416dB, High -87.5dB / .000dB (max abs .00020)
+    //R2.20 Key in ECO is far off in the spectrum on the sweep only. The key gates it 4 times a second and ECO opens the
+    //R2.20 gate a segment late, which changes how much of each sweep frequency gets through.
+    tp_golden_tolerance Tolerance[e_GoldenGroupCount][MakoSmackTalkCore::e_TierCount] = {
+        { { -1.0, -17.5, .12 }, { -1.0, -29.0, .06 }, { .001, -80.0, .05 } },     //R2.20 Main
+        { { -1.0, -15.5, .15 }, { -1.0, -22.5, .07 }, { .001, -70.0, .05 } },     //R2.20 Vox
+        { { -1.0, -15.0, .12 }, { -1.0, -17.5, .06 }, { .001, -80.0, .05 } },     //R2.20 Track
+        { { -1.0, -25.5, 2.5 }, { -1.0, -30.0, .50 }, { .001, -80.0, .05 } },     //R2.20 Key
+    };
+
+    //R2.20 Oversampled SMACK, spectrum only.
+    //R2.20 PROVISIONAL, seen 1.68dB (Standard) and 2.59dB (High) with the stand-in Oversampling. Its filters are what
+    //R2.20 this measures, so this one most needs a real JUCE build.
+    double Smack_OS_Spectral_dB = 3.0;
+};
+
+//R2.20 The result for one kernel set, tier and mode. The worst value over the whole corpus is kept.
+struct tp_golden_path
+{
+    juce::String Name;              //R2.20 "AVX2 High Talk"
+    int Tier = 0;
+    int Mode = 0;
+    int Group = e_GoldenMain;
+    double MaxAbs = 0.0;
+    double Null_dB = -300.0;
+    double Spectral_dB = 0.0;
+    double Speedup = 0.0;           //R2.20 Reference time / path time.
+    bool Spectrum_Only = false;     //R2.20 SMACK with oversampling.
+    juce::String Worst_Item;        //R2.20 Corpus item with the worst null.
+    bool Passed = true;
+};
+
+struct tp_golden_result
+{
+    std::vector<tp_golden_path> Paths;
+
+    bool Passed() const
+    {
+        for (const auto& p : Paths)
+            if (!p.Passed) return false;
+        return true;
+    }
+};
+
+//R2.20 Run the suite. Returns Result.Passed().
+bool Mako_Golden_Run(const tp_golden_config& Config, tp_golden_result& Result);
@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+
+    Mako_Kernels.cpp
+    R1.20 Pick which kernel table to use based on what the CPU can do.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "Mako_Kernels.h"
+
+//R1.20 Ask the CPU (CPUID) if it can run an instruction set.
+static bool Mako_Kernels_Supported(int Isa)
+{
+    switch (Isa)
+    {
+    case e_IsaScalar: return true;
+    case e_IsaSSE2: return juce::SystemStats::hasSSE2();
+    case e_IsaAVX2: return juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+    case e_IsaAVX512: return juce::SystemStats::hasAVX512F() && juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+    default: return false;
+    }
+}
+
+const tp_kernels* Mako_Kernels_Table(int Isa)
+{
+    switch (Isa)
+    {
+    case e_IsaSSE2: return Mako_Kernels_SSE2();
+    case e_IsaAVX2: return Mako_Kernels_AVX2();
+    case e_IsaAVX512: return Mako_Kernels_AVX512();
+    default: return Mako_Kernels_Scalar();
+    }
+}
+
+unsigned Mako_Kernels_Available()
+{
+    unsigned Available = 1u << e_IsaScalar;
+    for (int Isa = e_IsaSSE2; Isa < e_IsaCount; Isa++)
+        if ((Mako_Kernels_Table(Isa) != nullptr) && Mako_Kernels_Supported(Isa)) Available |= 1u << Isa;
+    return Available;
+}
+
+int Mako_Kernels_Pick(int Override, unsigned Available)
+{
+    //R1.20 Start at the best set (or the override) and work down until we find one that is available.
+    //R1.20 Unknown overrides are ignored, so they get the best set like Auto does.
+    int Isa = e_IsaAVX512;
+    if ((e_IsaAuto < Override) && (Override < e_IsaCount)) Isa = Override;
+
+    for (; e_IsaScalar < Isa; Isa--)
+        if ((Available & (1u << Isa)) != 0) return Isa;
+
+    //R1.20 Scalar always exists.
+    return e_IsaScalar;
+}
+
+const tp_kernels* Mako_Kernels_Select(int Override)
+{
+    return Mako_Kernels_Table(Mako_Kernels_Pick(Override, Mako_Kernels_Available()));
+}
+
+int Mako_Kernels_IsaFromName(const char* Name)
+{
+    juce::String Isa = juce::String(Name).trim().toLowerCase();
+
+    if (Isa == "scalar") return e_IsaScalar;
+    if (Isa == "sse2") return e_IsaSSE2;
+    if (Isa == "avx2") return e_IsaAVX2;
+    if (Isa == "avx512") return e_IsaAVX512;
+    return e_IsaAuto;
+}
+
+int Mako_Kernels_EnvOverride()
+{
+    return Mako_Kernels_IsaFromName(juce::SystemStats::getEnvironmentVariable("MAKO_SMACKTALK_ISA", "").toRawUTF8());
+}
+
+bool Mako_Kernels_SelfTest(const tp_kernels* k)
+{
+    const tp_kernels* ref = Mako_Kernels_Scalar();
+    if (k == nullptr) return false;
+    if (k == ref) return true;
+
+    //R1.20 A short test signal. Decaying sine with some noise like values.
+    const int num = 67;
+    float in[num], wetA[num], wetB[num], datA[num], datB[num];
+    for (int s = 0; s < num; s++) in[s] = std::sin(float(s) * .37f) * (1.0f - float(s) / float(num)) + ((s % 7) - 3) * .01f;
+
+    //R1.20 Both tables run the exact same steps. Different instruction sets can round a little differently.
+    auto Same = [](const float* a, const float* b, int n)
+    {
+        for (int s = 0; s < n; s++)
+            if (1.0e-4f < std::abs(a[s] - b[s])) return false;
+        return true;
+    };
+
+    float avgA = ref->Envelope(in, num, .1f, .005f, 1);
+    float avgB = k->Envelope(in, num, .1f, .005f, 1);
+    if (1.0e-4f < std::abs(avgA - avgB)) return false;
+
+    avgA = ref->Envelope(in, num, .1f, .02f, 4);
+    avgB = k->Envelope(in, num, .1f, .02f, 4);
+    if (1.0e-4f < std::abs(avgA - avgB)) return false;
+
+    avgA = ref->EnvelopeCoarse(in, num, .1f, .7f);
+    avgB = k->EnvelopeCoarse(in, num, .1f, .7f);
+    if (1.0e-4f < std::abs(avgA - avgB)) return false;
+
+    for (int s = 0; s < num; s++) { datA[s] = in[s]; datB[s] = in[s]; }
+    ref->GateRamp(datA, num, .2f, 1.0f);
+    k->GateRamp(datB, num, .2f, 1.0f);
+    if (!Same(datA, datB, num)) return false;
+
+    ref->SineShape(wetA, in, num, 7.0f, 9.0f, .2f, .15f);
+    k->SineShape(wetB, in, num, 7.0f, 9.0f, .2f, .15f);
+    if (!Same(wetA, wetB, num)) return false;
+
+    ref->SineShapeFast(wetA, in, num, 7.0f, 9.0f, .2f, .15f);
+    k->SineShapeFast(wetB, in, num, 7.0f, 9.0f, .2f, .15f);
+    if (!Same(wetA, wetB, num)) return false;
+
+    tp_filter fA = {};
+    fA.a0 = .2f; fA.a1 = .1f; fA.a2 = -.05f; fA.b1 = -.9f; fA.b2 = .3f;
+    tp_filter fB = fA;
+    tp_filter fT = fA;
+    fT.a0 = .25f; fT.b1 = -.8f;
+    ref->Biquad(wetA, in, num, &fA, &fT, 1);
+    k->Biquad(wetB, in, num, &fB, &fT, 1);
+    if (!Same(wetA, wetB, num)) return false;
+
+    tp_bankcoeffs target = {};
+    tp_bank bA = {};
+    for (int f = 0; f < Vox_Formants; f++)
+    {
+        bA.c[0].a0[f] = .05f * (f + 1); bA.c[0].b1[f] = -1.5f + .1f * f; bA.c[0].b2[f] = .8f;
+        target.a0[f] = .02f * (f + 1); target.b1[f] = -1.2f + .1f * f; target.b2[f] = .9f;
+    }
+    tp_bank bB = bA;
+    ref->VoxBank(wetA, in, num, &target, &bA, 0);
+    k->VoxBank(wetB, in, num, &target, &bB, 0);
+    if (!Same(wetA, wetB, num)) return false;
+
+    ref->MixDryWet(datA, wetA, num, .3f, .5f, .7f, .6f);
+    k->MixDryWet(datB, wetA, num, .3f, .5f, .7f, .6f);
+    if (!Same(datA, datB, num)) return false;
+
+    ref->Crossfade(datA, in, num);
+    k->Crossfade(datB, in, num);
+    if (!Same(datA, datB, num)) return false;
+
+    const int taps = 11;
+    ref->FirBlock(wetA, in, in + 40, num - taps, taps);
+    k->FirBlock(wetB, in, in + 40, num - taps, taps);
+    if (!Same(wetA, wetB, num - taps)) return false;
+
+    const int bins = 17;
+    for (int s = 0; s < bins * 2; s++) { wetA[s] = in[s + 20]; wetB[s] = in[s + 20]; }
+    ref->ComplexMAC(wetA, wetA + bins, in, in + bins, in + 30, in + 30 + bins, bins);
+    k->ComplexMAC(wetB, wetB + bins, in, in + bins, in + 30, in + 30 + bins, bins);
+    if (!Same(wetA, wetB, bins * 2)) return false;
+
+    ref->KeyLink(wetA, in, in + 20, num - 20, true);
+    k->KeyLink(wetB, in, in + 20, num - 20, true);
+    if (!Same(wetA, wetB, num - 20)) return false;
+
+    ref->KeyLink(wetA, in, in + 20, num - 20, false);
+    k->KeyLink(wetB, in, in + 20, num - 20, false);
+    if (!Same(wetA, wetB, num - 20)) return false;
+
+    for (int s = 0; s < num; s++) { datA[s] = in[s]; datB[s] = in[s]; }
+    ref->FadeEqualPower(datA, wetA, in + 10, in + 20, num - 20);
+    k->FadeEqualPower(datB, wetA, in + 10, in + 20, num - 20);
+    if (!Same(datA, datB, num - 20)) return false;
+
+    for (int s = 0; s < num; s++) { datA[s] = in[s] * 3.0f; datB[s] = in[s] * 3.0f; }
+    ref->SoftClip(datA, num, .9f);
+    k->SoftClip(datB, num, .9f);
+    if (!Same(datA, datB, num)) return false;
+
+    return true;
+}
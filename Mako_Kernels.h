@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    Mako_Kernels.h
+    R1.20 Our hot DSP loops (kernels). Each kernel works on a whole block of
+    samples and is compiled once per CPU instruction set (Scalar, SSE2, AVX2,
+    AVX512). The best set is picked once in prepareToPlay.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+//R1.20 Number of formants in the VOX filter bank.
+static const int Vox_Formants = 4;
+
+//R1.00 OUR FILTER VARIABLES
+struct tp_filter {
+    float a0;
+    float a1;
+    float a2;
+    float b1;
+    float b2;
+    float c0;
+    float d0;
+    float xn0[2];
+    float xn1[2];
+    float xn2[2];
+    float yn1[2];
+    float yn2[2];
+    float offset[2];
+};
+
+//R1.10 VOX (Talk Box) FORMANT BANK.
+//R1.10 Four bandpass formants that all share the same input. Each array index is one formant (lane)
+//R1.10 so the bank is processed as one parallel biquad. A bandpass has a1 = 0 and a2 = -a0, so only
+//R1.10 a0, b1, b2 are stored. The input history (xn) is shared by every formant.
+struct tp_bankcoeffs {
+    float a0[Vox_Formants];
+    float b1[Vox_Formants];
+    float b2[Vox_Formants];
+};
+
+struct tp_bank {
+    tp_bankcoeffs c[2];     //R1.30 The coeffs each channel is currently using. Ramped towards a target.
+    float xn1[2];
+    float xn2[2];
+    float yn1[2][Vox_Formants];
+    float yn2[2][Vox_Formants];
+};
+
+//R1.20 The kernel table. One of these exists for every instruction set we compiled.
+struct tp_kernels {
+    const char* Name;
+
+    //R1.20 Track the input signal average (Absolute vals). Returns the new average.
+    //R1.50 Uses in[0], in[step], in[step * 2]... so high sample rates can be decimated.
+    float (*Envelope)(const float* in, int num, float avg, float coef, int step);
+
+    //R1.40 Cheaper envelope. Uses the average of the whole segment instead of every sample.
+    float (*EnvelopeCoarse)(const float* in, int num, float avg, float keepN);
+
+    //R1.30 Most kernels RAMP a value from where it is (v0) to a new target (v1) over num samples.
+    //R1.30 Sample s gets v0 + (v1 - v0) * (s + 1) / num, so the last sample is exactly on target.
+
+    //R1.20 Noise gate. Ramp the gate factor from g0 to g1.
+    void (*GateRamp)(float* data, int num, float g0, float g1);
+
+    //R1.20 SMACK wave shaper. wet = sin(in * fac) * gain. fac and gain are ramped.
+    void (*SineShape)(float* wet, const float* in, int num, float fac0, float fac1, float gain0, float gain1);
+
+    //R1.40 Same as SineShape but with a polynomial sine.
+    void (*SineShapeFast)(float* wet, const float* in, int num, float fac0, float fac1, float gain0, float gain1);
+
+    //R1.20 Run a biquad filter from in to wet using the channels filter history.
+    //R1.30 The coeffs in fn are ramped to the coeffs in target and left there.
+    void (*Biquad)(float* wet, const float* in, int num, tp_filter* fn, const tp_filter* target, int channel);
+
+    //R1.20 VOX formant bank. The channels coeffs are ramped to target and left there.
+    void (*VoxBank)(float* wet, const float* in, int num, const tp_bankcoeffs* target, tp_bank* fb, int channel);
+
+    //R1.20 Final blend. data = data * dry + wet * wetGain.
+    //R2.80 Both gains are ramped (dry0 to dry1, wet0 to wet1).
+    void (*MixDryWet)(float* data, const float* wet, int num, float dry0, float dry1, float wet0, float wet1);
+
+    //R1.40 Fade data into next over num samples. data = data + (next - data) * (s + 1) / num.
+    void (*Crossfade)(float* data, const float* next, int num);
+
+    //R1.70 Direct form FIR. out[s] = sum of hRev[t] * in[s + t] for t < taps. hRev holds the taps backwards.
+    void (*FirBlock)(float* out, const float* in, const float* hRev, int num, int taps);
+
+    //R1.70 Complex multiply and add (acc += x * h) on split real/imag arrays. Used by the FFT convolution.
+    void (*ComplexMAC)(float* accRe, float* accIm, const float* xRe, const float* xIm, const float* hRe, const float* hIm, int num);
+
+    //R2.40 Stereo LINK detector input. key = max(|in0|, |in1|), or the average of the two if UseMax is false.
+    void (*KeyLink)(float* key, const float* in0, const float* in1, int num, bool UseMax);
+
+    //R2.50 Equal power fade. data = data * gainIn + from * gainOut. The gains are a table (sin and cos)
+    //R2.50 so the loudness does not dip in the middle like a straight line fade.
+    void (*FadeEqualPower)(float* data, const float* from, const float* gainIn, const float* gainOut, int num);
+
+    //R2.80 Output soft clipper. Untouched up to .85 of the ceiling, then bends over smoothly to exactly the ceiling.
+    void (*SoftClip)(float* data, int num, float ceiling);
+};
+
+//R1.20 The instruction sets we can select. Auto lets the CPU decide.
+enum { e_IsaAuto, e_IsaScalar, e_IsaSSE2, e_IsaAVX2, e_IsaAVX512, e_IsaCount };
+
+//R1.20 Kernel tables. A table is nullptr if that instruction set was not built for this CPU type.
+const tp_kernels* Mako_Kernels_Scalar();
+const tp_kernels* Mako_Kernels_SSE2();
+const tp_kernels* Mako_Kernels_AVX2();
+const tp_kernels* Mako_Kernels_AVX512();
+
+//R1.20 Pick the best kernels for this CPU. Override (e_Isa...) forces a lower set for A/B testing.
+const tp_kernels* Mako_Kernels_Select(int Override);
+
+//R1.20 The table for one instruction set (e_Isa...). nullptr if it was not built.
+const tp_kernels* Mako_Kernels_Table(int Isa);
+
+//R1.20 The sets that are built AND that this CPU can run. One bit per set (1 << e_Isa...).
+unsigned Mako_Kernels_Available();
+
+//R1.20 The set Mako_Kernels_Select uses for an Override and a group of Available sets.
+//R1.20 Kept apart from the CPU check so a test can try CPUs we do not have (see Tools/MakoKernelTest).
+int Mako_Kernels_Pick(int Override, unsigned Available);
+
+//R1.20 Read the MAKO_SMACKTALK_ISA environment variable (scalar, sse2, avx2, avx512).
+int Mako_Kernels_EnvOverride();
+
+//R1.20 Turn a set name (scalar, sse2, avx2, avx512) into e_Isa.... Anything else is e_IsaAuto.
+int Mako_Kernels_IsaFromName(const char* Name);
+
+//R1.20 Compare a kernel table against the Scalar table. Returns false if they do not match.
+bool Mako_Kernels_SelfTest(const tp_kernels* k);
@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    Mako_Kernels_AVX2.cpp
+    R1.20 AVX2 kernels. Only called when the CPU says it has AVX2.
+    GCC/Clang: the target is set below. MSVC: give this file a compiler flag scheme with /arch:AVX2.
+
+  ==============================================================================
+*/
+
+#include <cmath>
+#include <algorithm>      //R1.20 std::min and std::max in Mako_Kernels_Impl.h.
+#include "Mako_Kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+
+//R1.20 Compile everything below for AVX2.
+#if defined(__clang__)
+ #pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+ #pragma GCC target ("avx2,fma")
+#endif
+
+#define MAKO_KERNEL_NAME "AVX2"
+#define MAKO_KERNEL_FUNC Mako_Kernels_AVX2
+#include "Mako_Kernels_Impl.h"
+
+#if defined(__clang__)
+ #pragma clang attribute pop
+#endif
+
+#else
+
+//R1.20 Not an x86 CPU. There are no AVX2 kernels.
+const tp_kernels* Mako_Kernels_AVX2()
+{
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    Mako_Kernels_AVX512.cpp
+    R1.20 AVX512 kernels. Only called when the CPU says it has AVX512.
+    GCC/Clang: the target is set below. MSVC: give this file a compiler flag scheme with /arch:AVX512.
+
+  ==============================================================================
+*/
+
+#include <cmath>
+#include <algorithm>      //R1.20 std::min and std::max in Mako_Kernels_Impl.h.
+#include "Mako_Kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+
+//R1.20 Compile everything below for AVX512.
+#if defined(__clang__)
+ #pragma clang attribute push (__attribute__((target("avx512f,avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+ #pragma GCC target ("avx512f,avx2,fma")
+#endif
+
+#define MAKO_KERNEL_NAME "AVX512"
+#define MAKO_KERNEL_FUNC Mako_Kernels_AVX512
+#include "Mako_Kernels_Impl.h"
+
+#if defined(__clang__)
+ #pragma clang attribute pop
+#endif
+
+#else
+
+//R1.20 Not an x86 CPU. There are no AVX512 kernels.
+const tp_kernels* Mako_Kernels_AVX512()
+{
+    return nullptr;
+}
+
+#endif
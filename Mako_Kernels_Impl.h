@@ -0,0 +1,273 @@
+/*
+  ==============================================================================
+
+    Mako_Kernels_Impl.h
+    R1.20 The kernel loop bodies. Do NOT include this anywhere except the
+    Mako_Kernels_xxx.cpp files. Each of those sets the compiler target first
+    and defines:
+        MAKO_KERNEL_NAME  Text name of the instruction set.
+        MAKO_KERNEL_FUNC  Name of the function that returns the kernel table.
+        MAKO_LOOP         Optional loop pragma (used to stop vectorizing).
+
+  ==============================================================================
+*/
+
+#ifndef MAKO_LOOP
+ #define MAKO_LOOP
+#endif
+
+namespace
+{
+    float Kern_Envelope(const float* in, int num, float avg, float coef, int step)
+    {
+        //R1.20 This is a one pole filter so each sample needs the last one. It can not be split into lanes.
+        //R1.50 Only every step samples are used (decimated). step is 1 at normal sample rates.
+        float keep = 1.0f - coef;
+        MAKO_LOOP
+        for (int s = 0; s < num; s += step) avg = (avg * keep) + (std::abs(in[s]) * coef);
+        return avg;
+    }
+
+    float Kern_EnvelopeCoarse(const float* in, int num, float avg, float keepN)
+    {
+        //R1.40 Only the average level of the segment is used. The sum has no sample to sample link so it vectorizes.
+        float sum = 0.0f;
+        MAKO_LOOP
+        for (int s = 0; s < num; s++) sum += std::abs(in[s]);
+
+        //R1.40 keepN is (1 - coef) to the power of num, the same decay the fine envelope gets over num samples.
+        return (avg * keepN) + ((sum / float(num)) * (1.0f - keepN));
+    }
+
+    void Kern_GateRamp(float* data, int num, float g0, float g1)
+    {
+        float dg = (g1 - g0) / float(num);
+
+        MAKO_LOOP
+        for (int s = 0; s < num; s++) data[s] *= g0 + dg * float(s + 1);
+    }
+
+    void Kern_SineShape(float* wet, const float* in, int num, float fac0, float fac1, float gain0, float gain1)
+    {
+        float dfac = (fac1 - fac0) / float(num);
+        float dgain = (gain1 - gain0) / float(num);
+
+        MAKO_LOOP
+        for (int s = 0; s < num; s++)
+        {
+            float ramp = float(s + 1);
+            wet[s] = std::sin(in[s] * (fac0 + dfac * ramp)) * (gain0 + dgain * ramp);
+        }
+    }
+
+    void Kern_SineShapeFast(float* wet, const float* in, int num, float fac0, float fac1, float gain0, float gain1)
+    {
+        float dfac = (fac1 - fac0) / float(num);
+        float dgain = (gain1 - gain0) / float(num);
+
+        MAKO_LOOP
+        for (int s = 0; s < num; s++)
+        {
+            float ramp = float(s + 1);
+
+            //R1.40 Wrap to one cycle (-.5 to .5), then a parabola with a correction term. About 0.1% error, no branches.
+            float t = in[s] * (fac0 + dfac * ramp) * .159154943f;
+            t -= std::floor(t + .5f);
+            float y = 8.0f * t - 16.0f * t * std::abs(t);
+            y = .225f * (y * std::abs(y) - y) + y;
+
+            wet[s] = y * (gain0 + dgain * ramp);
+        }
+    }
+
+    void Kern_Biquad(float* wet, const float* in, int num, tp_filter* fn, const tp_filter* target, int channel)
+    {
+        //R1.20 Keep the filter history in locals so the compiler can hold them in registers.
+        float a0 = fn->a0, a1 = fn->a1, a2 = fn->a2, b1 = fn->b1, b2 = fn->b2;
+        float xn1 = fn->xn1[channel], xn2 = fn->xn2[channel];
+        float yn1 = fn->yn1[channel], yn2 = fn->yn2[channel];
+
+        //R1.30 How much each coeff moves per sample.
+        float step = 1.0f / float(num);
+        float da0 = (target->a0 - a0) * step, da1 = (target->a1 - a1) * step, da2 = (target->a2 - a2) * step;
+        float db1 = (target->b1 - b1) * step, db2 = (target->b2 - b2) * step;
+
+        MAKO_LOOP
+        for (int s = 0; s < num; s++)
+        {
+            a0 += da0; a1 += da1; a2 += da2; b1 += db1; b2 += db2;
+
+            float xn0 = in[s];
+            float tS = a0 * xn0 + a1 * xn1 + a2 * xn2 - b1 * yn1 - b2 * yn2;
+            xn2 = xn1; xn1 = xn0; yn2 = yn1; yn1 = tS;
+            wet[s] = tS;
+        }
+
+        //R1.30 Land exactly on target so rounding can not build up.
+        fn->a0 = target->a0; fn->a1 = target->a1; fn->a2 = target->a2; fn->b1 = target->b1; fn->b2 = target->b2;
+
+        fn->xn0[channel] = xn1;
+        fn->xn1[channel] = xn1; fn->xn2[channel] = xn2;
+        fn->yn1[channel] = yn1; fn->yn2[channel] = yn2;
+    }
+
+    void Kern_VoxBank(float* wet, const float* in, int num, const tp_bankcoeffs* target, tp_bank* fb, int channel)
+    {
+        tp_bankcoeffs* c = &fb->c[channel];
+        float* yn1 = fb->yn1[channel];
+        float* yn2 = fb->yn2[channel];
+        float xn1 = fb->xn1[channel];
+        float xn2 = fb->xn2[channel];
+
+        //R1.30 How much each coeff moves per sample.
+        float step = 1.0f / float(num);
+        float da0[Vox_Formants], db1[Vox_Formants], db2[Vox_Formants];
+        for (int f = 0; f < Vox_Formants; f++)
+        {
+            da0[f] = (target->a0[f] - c->a0[f]) * step;
+            db1[f] = (target->b1[f] - c->b1[f]) * step;
+            db2[f] = (target->b2[f] - c->b2[f]) * step;
+        }
+
+        for (int s = 0; s < num; s++)
+        {
+            //R1.10 a0 * x0 + a2 * x2 where a2 = -a0.
+            float xd = in[s] - xn2;
+            float tS = 0.0f;
+
+            //R1.20 The formants do not depend on each other. This is the loop that becomes one SIMD op.
+            MAKO_LOOP
+            for (int f = 0; f < Vox_Formants; f++)
+            {
+                c->a0[f] += da0[f]; c->b1[f] += db1[f]; c->b2[f] += db2[f];
+                float yn0 = c->a0[f] * xd - c->b1[f] * yn1[f] - c->b2[f] * yn2[f];
+                yn2[f] = yn1[f];
+                yn1[f] = yn0;
+                tS += yn0;
+            }
+
+            xn2 = xn1; xn1 = in[s];
+            wet[s] = tS;
+        }
+
+        //R1.30 Land exactly on target so rounding can not build up.
+        *c = *target;
+        fb->xn1[channel] = xn1;
+        fb->xn2[channel] = xn2;
+    }
+
+    void Kern_MixDryWet(float* data, const float* wet, int num, float dry0, float dry1, float wet0, float wet1)
+    {
+        float ddry = (dry1 - dry0) / float(num);
+        float dwet = (wet1 - wet0) / float(num);
+
+        //R2.80 A multiply and a multiply-add per sample. The AVX2 and AVX512 builds make it one FMA.
+        MAKO_LOOP
+        for (int s = 0; s < num; s++)
+        {
+            float ramp = float(s + 1);
+            data[s] = (data[s] * (dry0 + ddry * ramp)) + (wet[s] * (wet0 + dwet * ramp));
+        }
+    }
+
+    void Kern_Crossfade(float* data, const float* next, int num)
+    {
+        float step = 1.0f / float(num);
+
+        MAKO_LOOP
+        for (int s = 0; s < num; s++) data[s] += (next[s] - data[s]) * (step * float(s + 1));
+    }
+
+    void Kern_FirBlock(float* out, const float* in, const float* hRev, int num, int taps)
+    {
+        //R1.70 Each output is a dot product of the reversed taps with the input starting at in[s].
+        //R1.70 The inner loop is contiguous in both arrays so it vectorizes.
+        for (int s = 0; s < num; s++)
+        {
+            const float* x = in + s;
+            float sum = 0.0f;
+
+            MAKO_LOOP
+            for (int t = 0; t < taps; t++) sum += hRev[t] * x[t];
+            out[s] = sum;
+        }
+    }
+
+    void Kern_ComplexMAC(float* accRe, float* accIm, const float* xRe, const float* xIm, const float* hRe, const float* hIm, int num)
+    {
+        //R1.70 Split real/imag arrays so every lane does the same math (no shuffles).
+        MAKO_LOOP
+        for (int k = 0; k < num; k++)
+        {
+            accRe[k] += xRe[k] * hRe[k] - xIm[k] * hIm[k];
+            accIm[k] += xRe[k] * hIm[k] + xIm[k] * hRe[k];
+        }
+    }
+
+    void Kern_KeyLink(float* key, const float* in0, const float* in1, int num, bool UseMax)
+    {
+        //R2.40 Two loops with no branches inside, so both vectorize.
+        if (UseMax)
+        {
+            MAKO_LOOP
+            for (int s = 0; s < num; s++)
+            {
+                float a = std::abs(in0[s]), b = std::abs(in1[s]);
+                key[s] = (a < b) ? b : a;
+            }
+        }
+        else
+        {
+            MAKO_LOOP
+            for (int s = 0; s < num; s++) key[s] = .5f * (std::abs(in0[s]) + std::abs(in1[s]));
+        }
+    }
+
+    void Kern_FadeEqualPower(float* data, const float* from, const float* gainIn, const float* gainOut, int num)
+    {
+        MAKO_LOOP
+        for (int s = 0; s < num; s++) data[s] = (data[s] * gainIn[s]) + (from[s] * gainOut[s]);
+    }
+
+    void Kern_SoftClip(float* data, int num, float ceiling)
+    {
+        //R2.80 t is the level against the ceiling. Up to .85 it is left alone, from .85 to 1.15 a parabola
+        //R2.80 bends it over to exactly 1 (the slope is 1 at the start and 0 at the end), over 1.15 it stays at 1.
+        //R2.80 min/max instead of ifs so every lane does the same thing.
+        float inv = 1.0f / ceiling;
+
+        MAKO_LOOP
+        for (int s = 0; s < num; s++)
+        {
+            float x = data[s] * inv;
+            float t = std::abs(x);
+            float u = std::min(std::max(t - .85f, 0.0f), .3f);
+            float y = std::min(t, 1.15f) - (u * u * (1.0f / .6f));
+            data[s] = std::copysign(y * ceiling, x);
+        }
+    }
+
+    const tp_kernels Kernels_Table =
+    {
+        MAKO_KERNEL_NAME,
+        Kern_Envelope,
+        Kern_EnvelopeCoarse,
+        Kern_GateRamp,
+        Kern_SineShape,
+        Kern_SineShapeFast,
+        Kern_Biquad,
+        Kern_VoxBank,
+        Kern_MixDryWet,
+        Kern_Crossfade,
+        Kern_FirBlock,
+        Kern_ComplexMAC,
+        Kern_KeyLink,
+        Kern_FadeEqualPower,
+        Kern_SoftClip,
+    };
+}
+
+const tp_kernels* MAKO_KERNEL_FUNC()
+{
+    return &Kernels_Table;
+}
@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    Mako_Kernels_SSE2.cpp
+    R1.20 SSE2 kernels. Only called when the CPU says it has SSE2.
+    GCC/Clang: the target is set below. SSE2 is the x64 baseline so no extra flags are needed.
+
+  ==============================================================================
+*/
+
+#include <cmath>
+#include <algorithm>      //R1.20 std::min and std::max in Mako_Kernels_Impl.h.
+#include "Mako_Kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+
+//R1.20 Compile everything below for SSE2.
+#if defined(__clang__)
+ #pragma clang attribute push (__attribute__((target("sse2"))), apply_to = function)
+#elif defined(__GNUC__)
+ #pragma GCC target ("sse2")
+#endif
+
+#define MAKO_KERNEL_NAME "SSE2"
+#define MAKO_KERNEL_FUNC Mako_Kernels_SSE2
+#include "Mako_Kernels_Impl.h"
+
+#if defined(__clang__)
+ #pragma clang attribute pop
+#endif
+
+#else
+
+//R1.20 Not an x86 CPU. There are no SSE2 kernels.
+const tp_kernels* Mako_Kernels_SSE2()
+{
+    return nullptr;
+}
+
+#endif
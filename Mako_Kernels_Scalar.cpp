@@ -0,0 +1,26 @@
+/*
+  ==============================================================================
+
+    Mako_Kernels_Scalar.cpp
+    R1.20 Plain C++ kernels. Always built, always works. Vectorizing is turned
+    off so this is a true scalar reference for A/B testing.
+
+  ==============================================================================
+*/
+
+#include <cmath>
+#include <algorithm>      //R1.20 std::min and std::max in Mako_Kernels_Impl.h.
+#include "Mako_Kernels.h"
+
+//R1.20 Stop the compiler from vectorizing our loops.
+#if defined(_MSC_VER)
+ #define MAKO_LOOP __pragma(loop(no_vector))
+#elif defined(__clang__)
+ #define MAKO_LOOP _Pragma("clang loop vectorize(disable)")
+#elif defined(__GNUC__)
+ #pragma GCC optimize ("no-tree-vectorize")
+#endif
+
+#define MAKO_KERNEL_NAME "Scalar"
+#define MAKO_KERNEL_FUNC Mako_Kernels_Scalar
+#include "Mako_Kernels_Impl.h"
@@ -0,0 +1,176 @@
+/*
+  ==============================================================================
+
+    Mako_Pitch.cpp
+    R1.80 Real time pitch detector. See Mako_Pitch.h.
+
+  ==============================================================================
+*/
+
+#include "Mako_Pitch.h"
+
+MakoPitch::MakoPitch()
+{
+    //R1.80 FFT size is 2 x Win so the autocorrelation does not wrap around.
+    Fft = std::make_unique<juce::dsp::FFT>(Win_Order + 1);
+
+    Ring.allocate(size_t(Win), true);
+    Frame.allocate(size_t(Win), true);
+    Work.allocate(size_t(Win * 4), true);
+    Energy.allocate(size_t(Win + 1), true);
+}
+
+void MakoPitch::prepare(double sampleRate)
+{
+    //R1.80 Decimate to about 6kHz. 48kHz = 8, 96kHz = 16, 44.1kHz = 7.
+    Decim = juce::jmax(1, int(std::round(float(sampleRate) / Target_Rate)));
+    Rate = float(sampleRate) / float(Decim);
+
+    //R1.80 Low pass at about 1/3 of the decimated Nyquist before throwing samples away.
+    Dec_Coef = 1.0f - std::exp(-6.2831853f * (Rate * .16f) / float(sampleRate));
+
+    reset();
+}
+
+void MakoPitch::reset()
+{
+    juce::FloatVectorOperations::clear(Ring, Win);
+    Ring_Pos = 0;
+    Hop_Count = 0;
+    Filled = 0;
+    Stage = e_StageIdle;
+    Dec_Count = 0;
+    Dec_Sum = 0.0f;
+    Dec_LP = 0.0f;
+    Pitch = 0.0f;
+    Confidence = 0.0f;
+}
+
+void MakoPitch::process(const float* in, int num)
+{
+    for (int s = 0; s < num; s++)
+    {
+        //R1.80 Low pass, then average Decim samples into one.
+        Dec_LP += (in[s] - Dec_LP) * Dec_Coef;
+        Dec_Sum += Dec_LP;
+        if (++Dec_Count < Decim) continue;
+
+        Ring[Ring_Pos] = Dec_Sum / float(Decim);
+        Ring_Pos = (Ring_Pos + 1) & (Win - 1);
+        Dec_Count = 0;
+        Dec_Sum = 0.0f;
+
+        if (Filled < Win) Filled++;
+        if (++Hop_Count < Hop) continue;
+
+        //R1.80 Wait for a full window before the first check.
+        //R1.80 A very big block can bring the next hop before the last check is done. Finish it first.
+        Hop_Count = 0;
+        if (Filled < Win) continue;
+        while (Stage != e_StageIdle) Mako_Pitch_Step();
+        Mako_Pitch_Snapshot();
+    }
+
+    //R1.80 One stage of the check per call, so no single block pays for all of it.
+    if (Stage != e_StageIdle) Mako_Pitch_Step();
+}
+
+//R1.80 Take a copy of the window (oldest sample first) and its running energy. The check runs on this copy.
+void MakoPitch::Mako_Pitch_Snapshot()
+{
+    Energy[0] = 0.0f;
+    for (int j = 0; j < Win; j++)
+    {
+        Frame[j] = Ring[(Ring_Pos + j) & (Win - 1)];
+        Energy[j + 1] = Energy[j] + Frame[j] * Frame[j];
+    }
+
+    //R1.80 Too quiet to be a note. Keep the last pitch.
+    if (Energy[Win] < (float(Win) * 1.0e-7f))
+    {
+        Confidence = 0.0f;
+        return;
+    }
+
+    Stage = e_StageForward;
+}
+
+void MakoPitch::Mako_Pitch_Step()
+{
+    const int N = Win * 2;
+
+    switch (Stage)
+    {
+    case e_StageForward:
+        //R1.80 Autocorrelation by FFT: r = IFFT(|FFT(x)|^2), zero padded to 2 x Win.
+        juce::FloatVectorOperations::copy(Work, Frame, Win);
+        juce::FloatVectorOperations::clear(Work + Win, N * 2 - Win);
+        Fft->performRealOnlyForwardTransform(Work, true);
+
+        for (int k = 0; k <= Win; k++)
+        {
+            float re = Work[k * 2], im = Work[k * 2 + 1];
+            Work[k * 2] = re * re + im * im;
+            Work[k * 2 + 1] = 0.0f;
+        }
+        for (int k = Win + 1; k < N; k++) { Work[k * 2] = Work[(N - k) * 2]; Work[k * 2 + 1] = 0.0f; }
+        Stage = e_StageInverse;
+        break;
+
+    case e_StageInverse:
+        Fft->performRealOnlyInverseTransform(Work);
+        Stage = e_StageSearch;
+        break;
+
+    default:
+        Mako_Pitch_Search();
+        Stage = e_StageIdle;
+        break;
+    }
+}
+
+//R1.80 YIN on the autocorrelation in Work.
+void MakoPitch::Mako_Pitch_Search()
+{
+    const int TauMax = Win / 2;
+    const int TauMin = juce::jmax(2, int(Rate / Max_Hz));
+
+    //R1.80 YIN. d(tau) = sum (x[j] - x[j + tau])^2 = E(first part) + E(second part) - 2 r(tau).
+    //R1.80 Then normalize by the running average (CMNDF) and take the first dip under Threshold.
+    //R1.80 Work is reused to hold the normalized values, Work[tau] is only read before it is written.
+    float RunSum = 0.0f;
+    int Best = -1;
+    for (int tau = 1; tau <= TauMax; tau++)
+    {
+        float d = Energy[Win - tau] + (Energy[Win] - Energy[tau]) - 2.0f * Work[tau];
+        if (d < 0.0f) d = 0.0f;
+        RunSum += d;
+        Work[tau] = (0.0f < RunSum) ? d * float(tau) / RunSum : 1.0f;
+    }
+
+    for (int tau = TauMin; tau < TauMax; tau++)
+    {
+        if (Work[tau] < Threshold)
+        {
+            //R1.80 Walk down to the bottom of the dip.
+            while (((tau + 1) < TauMax) && (Work[tau + 1] < Work[tau])) tau++;
+            Best = tau;
+            break;
+        }
+    }
+
+    if (Best < 0)
+    {
+        Confidence = 0.0f;
+        return;
+    }
+
+    //R1.80 Parabola through the dip for a fraction of a sample.
+    float a = Work[Best - 1], b = Work[Best], c = Work[Best + 1];
+    float den = a - 2.0f * b + c;
+    float Shift = (1.0e-9f < std::abs(den)) ? .5f * (a - c) / den : 0.0f;
+    Shift = juce::jlimit(-.5f, .5f, Shift);
+
+    Pitch = Rate / (float(Best) + Shift);
+    Confidence = juce::jlimit(0.0f, 1.0f, 1.0f - b);
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    Mako_Pitch.h
+    R1.80 Real time pitch detector for the TRACK mode. YIN method with the
+    autocorrelation done by FFT.
+
+    The input is filtered and decimated to about 6kHz (plenty for guitar and
+    bass notes). Every Hop decimated samples the last Win samples are checked.
+    The detector only reads the audio, so it adds no latency. The result is a
+    few ms old, which is fine for moving a filter. The check is spread over
+    three process calls so its cost per block stays small and flat.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class MakoPitch
+{
+public:
+    MakoPitch();
+
+    void prepare(double sampleRate);
+    void reset();
+
+    //R1.80 Feed audio. The detector runs inside here once every Hop decimated samples.
+    void process(const float* in, int num);
+
+    //R1.80 Last detected pitch in Hz (0 = nothing found yet). Held when the signal is not a clear note.
+    float Pitch = 0.0f;
+
+    //R1.80 How sure we are about the current block (0 to 1). 0 when the last check found no note.
+    float Confidence = 0.0f;
+
+    //R1.80 Window and hop in decimated samples. Win/2 is the longest period we can find (about 23Hz).
+    static const int Win_Order = 9;
+    static const int Win = 1 << Win_Order;
+    static const int Hop = 128;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE(MakoPitch)
+
+    //R1.80 The check is split into stages. Each process call runs at most one (plus the snapshot).
+    enum { e_StageIdle, e_StageForward, e_StageInverse, e_StageSearch, };
+    int Stage = e_StageIdle;
+    void Mako_Pitch_Snapshot();
+    void Mako_Pitch_Step();
+    void Mako_Pitch_Search();
+
+    const float Target_Rate = 6000.0f;  //R1.80 Decimated rate we aim for.
+    const float Max_Hz = 1500.0f;       //R1.80 Highest note we look for.
+    const float Threshold = .15f;       //R1.80 YIN dip threshold. Lower = stricter.
+
+    std::unique_ptr<juce::dsp::FFT> Fft;
+    float Rate = 6000.0f;               //R1.80 Actual decimated rate.
+    int Decim = 8;
+    int Dec_Count = 0;
+    float Dec_Sum = 0.0f;
+    float Dec_LP = 0.0f;                //R1.80 One pole low pass before decimating.
+    float Dec_Coef = .2f;
+
+    //R1.80 Ring buffer of decimated input and our scratch. Sized in the constructor, never in process.
+    juce::HeapBlock<float> Ring;
+    int Ring_Pos = 0;
+    int Hop_Count = 0;
+    int Filled = 0;
+
+    juce::HeapBlock<float> Frame;       //R1.80 Win samples, oldest first.
+    juce::HeapBlock<float> Work;        //R1.80 FFT in/out. 2 x FFT size (FFT size is 2 x Win).
+    juce::HeapBlock<float> Energy;      //R1.80 Running sum of squares, Win + 1.
+};
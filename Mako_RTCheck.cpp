@@ -0,0 +1,424 @@
+/*
+  ==============================================================================
+
+    Mako_RTCheck.cpp
+    R1.90 REAL TIME SAFETY CHECK. See Mako_RTCheck.h.
+
+  ==============================================================================
+*/
+
+#include "Mako_RTCheck.h"
+
+#if MAKO_RT_CHECK
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+//R1.90 On Linux (glibc) we can also hook the C library. Everywhere else only operator new/delete.
+#if defined(__linux__) && defined(__GLIBC__)
+ #include <dlfcn.h>
+ #include <fcntl.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <time.h>
+ #include <unistd.h>
+ #define MAKO_RT_HOOK_LIBC 1
+#else
+ #define MAKO_RT_HOOK_LIBC 0
+#endif
+
+//R1.90 Our thread flags are read from inside malloc. initial-exec TLS never allocates, so it can not call back into us.
+#if defined(__GNUC__)
+ #define MAKO_RT_TLS thread_local __attribute__((tls_model("initial-exec")))
+#else
+ #define MAKO_RT_TLS thread_local
+#endif
+
+#if MAKO_RT_HOOK_LIBC
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+extern "C" void __libc_free(void*);
+extern "C" void* __libc_memalign(size_t, size_t);
+#endif
+
+#if defined(_WIN32)
+ #include <malloc.h>
+#endif
+
+namespace
+{
+    MAKO_RT_TLS int RT_Depth = 0;           //R1.90 More than 0 while inside a MakoRTScope.
+    MAKO_RT_TLS bool RT_Reporting = false;  //R1.90 True while we print a report (it allocates and writes).
+    std::atomic<int> RT_Count { 0 };
+
+    void Mako_RT_Violation(const char* What)
+    {
+        RT_Reporting = true;
+        RT_Count++;
+
+        //R1.90 In its own scope so the trace is freed before the checks are turned back on.
+        {
+            juce::String Trace = juce::SystemStats::getStackBacktrace();
+            std::fprintf(stderr, "MAKO RT CHECK: %s on the audio thread\n%s\n", What, Trace.toRawUTF8());
+            std::fflush(stderr);
+        }
+
+        //R1.90 Test runs want to stop right here. Debuggers stop on the jassert.
+        if (std::getenv("MAKO_RT_ABORT") != nullptr) std::abort();
+        jassertfalse;
+
+        RT_Reporting = false;
+    }
+
+    inline void Mako_RT_Check(const char* What)
+    {
+        if ((0 < RT_Depth) && !RT_Reporting) Mako_RT_Violation(What);
+    }
+
+    //R1.90 Allocate without being checked again (operator new already did the check).
+    inline void* Mako_RT_RawAlloc(std::size_t n)
+    {
+       #if MAKO_RT_HOOK_LIBC
+        return __libc_malloc(n);
+       #else
+        return std::malloc(n);
+       #endif
+    }
+
+    inline void Mako_RT_RawFree(void* p)
+    {
+       #if MAKO_RT_HOOK_LIBC
+        __libc_free(p);
+       #else
+        std::free(p);
+       #endif
+    }
+
+    //R1.90 The same for over-aligned types (SIMD structs with alignas). Windows needs its own free for these.
+    inline void* Mako_RT_RawAlignedAlloc(std::size_t n, std::size_t Align)
+    {
+       #if MAKO_RT_HOOK_LIBC
+        return __libc_memalign(Align, n);
+       #elif defined(_WIN32)
+        return _aligned_malloc(n, Align);
+       #else
+        void* p = nullptr;
+        return (posix_memalign(&p, (Align < sizeof(void*)) ? sizeof(void*) : Align, n) == 0) ? p : nullptr;
+       #endif
+    }
+
+    inline void Mako_RT_RawAlignedFree(void* p)
+    {
+       #if defined(_WIN32) && !MAKO_RT_HOOK_LIBC
+        _aligned_free(p);
+       #else
+        Mako_RT_RawFree(p);
+       #endif
+    }
+}
+
+MakoRTScope::MakoRTScope()
+{
+    RT_Depth++;
+}
+
+MakoRTScope::~MakoRTScope()
+{
+    RT_Depth--;
+}
+
+int Mako_RT_Violations()
+{
+    return RT_Count.load();
+}
+
+void Mako_RT_ResetViolations()
+{
+    RT_Count = 0;
+}
+
+//==============================================================================
+//R1.90 operator new/delete. Catches every C++ container, juce::String, std::function etc.
+void* operator new(std::size_t n)
+{
+    Mako_RT_Check("operator new");
+    if (void* p = Mako_RT_RawAlloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t n)
+{
+    Mako_RT_Check("operator new[]");
+    if (void* p = Mako_RT_RawAlloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept
+{
+    Mako_RT_Check("operator new");
+    return Mako_RT_RawAlloc(n ? n : 1);
+}
+
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept
+{
+    Mako_RT_Check("operator new[]");
+    return Mako_RT_RawAlloc(n ? n : 1);
+}
+
+void operator delete(void* p) noexcept
+{
+    if (p != nullptr) Mako_RT_Check("operator delete");
+    Mako_RT_RawFree(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    if (p != nullptr) Mako_RT_Check("operator delete[]");
+    Mako_RT_RawFree(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    if (p != nullptr) Mako_RT_Check("operator delete");
+    Mako_RT_RawFree(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    if (p != nullptr) Mako_RT_Check("operator delete[]");
+    Mako_RT_RawFree(p);
+}
+
+//R1.90 Aligned new/delete (C++17). Used for anything declared alignas() bigger than the normal alignment.
+void* operator new(std::size_t n, std::align_val_t Align)
+{
+    Mako_RT_Check("aligned operator new");
+    if (void* p = Mako_RT_RawAlignedAlloc(n ? n : 1, std::size_t(Align))) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t n, std::align_val_t Align)
+{
+    Mako_RT_Check("aligned operator new[]");
+    if (void* p = Mako_RT_RawAlignedAlloc(n ? n : 1, std::size_t(Align))) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t n, std::align_val_t Align, const std::nothrow_t&) noexcept
+{
+    Mako_RT_Check("aligned operator new");
+    return Mako_RT_RawAlignedAlloc(n ? n : 1, std::size_t(Align));
+}
+
+void* operator new[](std::size_t n, std::align_val_t Align, const std::nothrow_t&) noexcept
+{
+    Mako_RT_Check("aligned operator new[]");
+    return Mako_RT_RawAlignedAlloc(n ? n : 1, std::size_t(Align));
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    if (p != nullptr) Mako_RT_Check("aligned operator delete");
+    Mako_RT_RawAlignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+    if (p != nullptr) Mako_RT_Check("aligned operator delete[]");
+    Mako_RT_RawAlignedFree(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    if (p != nullptr) Mako_RT_Check("aligned operator delete");
+    Mako_RT_RawAlignedFree(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept
+{
+    if (p != nullptr) Mako_RT_Check("aligned operator delete[]");
+    Mako_RT_RawAlignedFree(p);
+}
+
+//==============================================================================
+#if MAKO_RT_HOOK_LIBC
+
+namespace
+{
+    //R1.90 The real functions, found with dlsym. Looked up when the library loads, before any audio runs.
+    typedef int (*tp_posix_memalign)(void**, size_t, size_t);
+    typedef void* (*tp_aligned_alloc)(size_t, size_t);
+    typedef void* (*tp_memalign)(size_t, size_t);
+    typedef int (*tp_mutex_lock)(pthread_mutex_t*);
+    typedef int (*tp_sem_wait)(sem_t*);
+    typedef ssize_t (*tp_read)(int, void*, size_t);
+    typedef ssize_t (*tp_write)(int, const void*, size_t);
+    typedef int (*tp_open)(const char*, int, ...);
+    typedef int (*tp_open64)(const char*, int, ...);
+    typedef int (*tp_nanosleep)(const struct timespec*, struct timespec*);
+    typedef int (*tp_usleep)(useconds_t);
+
+    tp_posix_memalign Real_PosixMemalign = nullptr;
+    tp_aligned_alloc Real_AlignedAlloc = nullptr;
+    tp_memalign Real_Memalign = nullptr;
+    tp_mutex_lock Real_MutexLock = nullptr;
+    tp_sem_wait Real_SemWait = nullptr;
+    tp_read Real_Read = nullptr;
+    tp_write Real_Write = nullptr;
+    tp_open Real_Open = nullptr;
+    tp_open64 Real_Open64 = nullptr;
+    tp_nanosleep Real_Nanosleep = nullptr;
+    tp_usleep Real_Usleep = nullptr;
+
+    template <typename T>
+    T Mako_RT_Real(T& Fn, const char* Name)
+    {
+        if (Fn == nullptr) Fn = reinterpret_cast<T>(dlsym(RTLD_NEXT, Name));
+        return Fn;
+    }
+
+    struct tp_resolver
+    {
+        tp_resolver()
+        {
+            Mako_RT_Real(Real_PosixMemalign, "posix_memalign");
+            Mako_RT_Real(Real_AlignedAlloc, "aligned_alloc");
+            Mako_RT_Real(Real_Memalign, "memalign");
+            Mako_RT_Real(Real_MutexLock, "pthread_mutex_lock");
+            Mako_RT_Real(Real_SemWait, "sem_wait");
+            Mako_RT_Real(Real_Read, "read");
+            Mako_RT_Real(Real_Write, "write");
+            Mako_RT_Real(Real_Open, "open");
+            Mako_RT_Real(Real_Open64, "open64");
+            Mako_RT_Real(Real_Nanosleep, "nanosleep");
+            Mako_RT_Real(Real_Usleep, "usleep");
+        }
+    };
+
+    tp_resolver Resolver;
+}
+
+extern "C"
+{
+    //R1.90 Memory.
+    void* malloc(size_t n)
+    {
+        Mako_RT_Check("malloc");
+        return __libc_malloc(n);
+    }
+
+    void* calloc(size_t num, size_t n)
+    {
+        Mako_RT_Check("calloc");
+        return __libc_calloc(num, n);
+    }
+
+    void* realloc(void* p, size_t n)
+    {
+        Mako_RT_Check("realloc");
+        return __libc_realloc(p, n);
+    }
+
+    void free(void* p)
+    {
+        if (p != nullptr) Mako_RT_Check("free");
+        __libc_free(p);
+    }
+
+    //R1.90 Aligned memory. The real ones check the alignment, so they are called instead of __libc_memalign.
+    int posix_memalign(void** p, size_t Align, size_t n)
+    {
+        Mako_RT_Check("posix_memalign");
+        return Mako_RT_Real(Real_PosixMemalign, "posix_memalign")(p, Align, n);
+    }
+
+    void* aligned_alloc(size_t Align, size_t n)
+    {
+        Mako_RT_Check("aligned_alloc");
+        return Mako_RT_Real(Real_AlignedAlloc, "aligned_alloc")(Align, n);
+    }
+
+    void* memalign(size_t Align, size_t n)
+    {
+        Mako_RT_Check("memalign");
+        return Mako_RT_Real(Real_Memalign, "memalign")(Align, n);
+    }
+
+    //R1.90 Locks. juce::CriticalSection and std::mutex both end up here. A condition wait needs a locked mutex, so it is caught too.
+    int pthread_mutex_lock(pthread_mutex_t* m)
+    {
+        Mako_RT_Check("pthread_mutex_lock");
+        return Mako_RT_Real(Real_MutexLock, "pthread_mutex_lock")(m);
+    }
+
+    int sem_wait(sem_t* s)
+    {
+        Mako_RT_Check("sem_wait");
+        return Mako_RT_Real(Real_SemWait, "sem_wait")(s);
+    }
+
+    //R1.90 Blocking system calls. File and pipe IO, and sleeping.
+    ssize_t read(int fd, void* buf, size_t n)
+    {
+        Mako_RT_Check("read");
+        return Mako_RT_Real(Real_Read, "read")(fd, buf, n);
+    }
+
+    ssize_t write(int fd, const void* buf, size_t n)
+    {
+        Mako_RT_Check("write");
+        return Mako_RT_Real(Real_Write, "write")(fd, buf, n);
+    }
+
+    int open(const char* path, int flags, ...)
+    {
+        Mako_RT_Check("open");
+
+        mode_t Mode = 0;
+        if ((flags & O_CREAT) != 0)
+        {
+            va_list args;
+            va_start(args, flags);
+            Mode = mode_t(va_arg(args, int));
+            va_end(args);
+        }
+        return Mako_RT_Real(Real_Open, "open")(path, flags, Mode);
+    }
+
+    //R1.90 Large file builds (and some libraries) call open64 instead of open.
+    int open64(const char* path, int flags, ...)
+    {
+        Mako_RT_Check("open64");
+
+        mode_t Mode = 0;
+        if ((flags & O_CREAT) != 0)
+        {
+            va_list args;
+            va_start(args, flags);
+            Mode = mode_t(va_arg(args, int));
+            va_end(args);
+        }
+        return Mako_RT_Real(Real_Open64, "open64")(path, flags, Mode);
+    }
+
+    int nanosleep(const struct timespec* req, struct timespec* rem)
+    {
+        Mako_RT_Check("nanosleep");
+        return Mako_RT_Real(Real_Nanosleep, "nanosleep")(req, rem);
+    }
+
+    int usleep(useconds_t us)
+    {
+        Mako_RT_Check("usleep");
+        return Mako_RT_Real(Real_Usleep, "usleep")(us);
+    }
+}
+
+#endif // MAKO_RT_HOOK_LIBC
+
+#endif // MAKO_RT_CHECK
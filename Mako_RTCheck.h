@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    Mako_RTCheck.h
+    R1.90 REAL TIME SAFETY CHECK. The audio thread must never allocate memory,
+    take a lock or make a blocking system call. Any of those can make the
+    audio drop out when the OS decides to make us wait.
+
+    Build with MAKO_RT_CHECK=1 (add it to the Debug preprocessor definitions
+    in Projucer) to catch them. Every function that runs on the audio thread
+    starts with a MakoRTScope. While a scope is open on a thread:
+      - operator new/delete (std::vector, juce::String...)         all systems
+        and the aligned ones (alignas SIMD types)
+      - malloc, calloc, realloc, free                              Linux
+      - posix_memalign, aligned_alloc, memalign                    Linux
+      - pthread mutex lock, condition wait, semaphore wait         Linux
+      - read, write, open, open64, sleep                           Linux
+    are reported with a stack trace and counted. Set the MAKO_RT_ABORT
+    environment variable to stop the program on the first one (for test runs).
+
+    The Linux rows only work in a program that has this file linked into the
+    executable (the Tools programs, test programs). A plugin is loaded with
+    dlopen by a host that already has its C library loaded, and malloc, free,
+    pthread_mutex_lock, read, write... are looked up there first, so inside a
+    DAW they never fire. Check the audio path with Tools/MakoStress instead.
+
+    With MAKO_RT_CHECK=0 (the default) MakoRTScope is empty and nothing is
+    hooked.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#ifndef MAKO_RT_CHECK
+ #define MAKO_RT_CHECK 0
+#endif
+
+#if MAKO_RT_CHECK
+
+//R1.90 Marks this thread as the audio thread until the scope closes. Scopes can be nested.
+struct MakoRTScope
+{
+    MakoRTScope();
+    ~MakoRTScope();
+};
+
+//R1.90 Number of problems found since the program started (or the last reset). 0 = good.
+int Mako_RT_Violations();
+void Mako_RT_ResetViolations();
+
+#else
+
+//R1.90 Nothing to do. Declare scopes [[maybe_unused]] so this build stays free of unused variable warnings.
+struct MakoRTScope
+{
+};
+
+inline int Mako_RT_Violations() { return 0; }
+inline void Mako_RT_ResetViolations() {}
+
+#endif
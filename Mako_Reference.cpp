@@ -0,0 +1,253 @@
+/*
+  ==============================================================================
+
+    Mako_Reference.cpp
+    R2.20 FROZEN REFERENCE. See Mako_Reference.h.
+
+  ==============================================================================
+*/
+
+#include "Mako_Reference.h"
+#include <algorithm>
+#include <cmath>
+
+void MakoReferenceChain::prepare(double sampleRate, int Lookahead)
+{
+    SampleRate = (0.0 < sampleRate) ? sampleRate : 48000.0;
+    for (int line = 0; line < 4; line++) Dly[line].assign(size_t(std::max(0, Lookahead)) + 1, 0.0);
+
+    //R2.20 The envelope decays by .995 per sample at 48kHz, whatever the sample rate.
+    Env_Coef = 1.0 - std::pow(.995, 48000.0 / SampleRate);
+
+    //R2.20 The core's micro block is 64 samples, stretched at high sample rates like its control path.
+    int Decim = 1;
+    while ((Decim < 8) && ((72000.0 * double(Decim)) < SampleRate)) Decim *= 2;
+    Micro_Size = 64 * Decim;
+
+    for (int channel = 0; channel < 2; channel++) Pitch[channel].prepare(SampleRate);
+    Mako_Vox_Table();
+    reset();
+}
+
+void MakoReferenceChain::reset()
+{
+    for (int channel = 0; channel < 2; channel++)
+    {
+        Signal_AVG[channel] = 0.0;
+        xn1[channel] = 0.0; xn2[channel] = 0.0;
+        yn1[channel] = 0.0; yn2[channel] = 0.0;
+        Vox_xn1[channel] = 0.0; Vox_xn2[channel] = 0.0;
+        for (int f = 0; f < Vox_Formants; f++) { Vox_yn1[channel][f] = 0.0; Vox_yn2[channel][f] = 0.0; }
+        Pitch[channel].reset();
+    }
+
+    for (int line = 0; line < 4; line++)
+    {
+        std::fill(Dly[line].begin(), Dly[line].end(), 0.0);
+        Dly_Pos[line] = 0;
+    }
+    Micro_Pos = 0;
+}
+
+void MakoReferenceChain::process(float* const* channels, int numChannels, int numSamples, float* const* key, int numKeyChannels)
+{
+    if (2 < numChannels) numChannels = 2;
+    if (key == nullptr) numKeyChannels = 0;
+    if (2 < numKeyChannels) numKeyChannels = 2;
+    if (Setting[MakoSmackTalkCore::e_Q] != Vox_Q) Mako_Vox_Table();
+
+    //R2.20 BYPASS. Every channel untouched, FORCE MONO or not, delayed by our latency.
+    if (Bypass)
+    {
+        for (int channel = 0; channel < numChannels; channel++)
+            for (int s = 0; s < numSamples; s++) channels[channel][s] = float(Mako_Delay(double(channels[channel][s]), 2 + channel));
+        return;
+    }
+
+    //R2.20 FORCE MONO - Only channel 0 is processed. It is copied to channel 1 after.
+    int numProc = ((.5f < Setting[MakoSmackTalkCore::e_Mono]) && (1 < numChannels)) ? 1 : numChannels;
+    int Detect = int(Setting[MakoSmackTalkCore::e_Detect]);
+    bool Track = (int(Setting[MakoSmackTalkCore::e_Mode]) == MakoSmackTalkCore::e_ModeTrack);
+
+    //R2.20 Cut the block where the core cuts it (micro block and block ends). TRACK's pitch detector hears each
+    //R2.20 piece before its samples are filtered, like in the core, so the note changes on the same sample.
+    for (int start = 0, num = 0; start < numSamples; start += num)
+    {
+        num = std::min(Micro_Size - Micro_Pos, numSamples - start);
+        if (Track)
+            for (int channel = 0; channel < numProc; channel++) Pitch[channel].process(channels[channel] + start, num);
+
+        for (int s = start; s < start + num; s++)
+        {
+            //R2.20 LINK or KEY. What both envelopes hear (-1 = each channel hears itself).
+            double Link = -1.0;
+            if ((Detect == MakoSmackTalkCore::e_DetectKey) && (0 < numKeyChannels))
+            {
+                Link = std::abs(double(key[0][s]));
+                if (1 < numKeyChannels) Link = std::max(Link, std::abs(double(key[1][s])));
+            }
+            else if ((numProc == 2) && (Detect == MakoSmackTalkCore::e_DetectLinkMax))
+                Link = std::max(std::abs(double(channels[0][s])), std::abs(double(channels[1][s])));
+            else if ((numProc == 2) && (Detect == MakoSmackTalkCore::e_DetectLinkAvg))
+                Link = .5 * (std::abs(double(channels[0][s])) + std::abs(double(channels[1][s])));
+
+            for (int channel = 0; channel < numProc; channel++)
+                channels[channel][s] = float(Mako_Sample(double(channels[channel][s]), channel, Link));
+        }
+
+        Micro_Pos = (Micro_Pos + num) % Micro_Size;
+    }
+
+    if (numProc < numChannels)
+        for (int s = 0; s < numSamples; s++) channels[1][s] = channels[0][s];
+
+    //R2.20 OUTPUT SAFETY. Left alone up to .85 of the ceiling, a parabola from .85 to 1.15, the ceiling over that.
+    if (OutClip)
+    {
+        double Ceiling = std::pow(10.0, std::min(0.0, std::max(-24.0, double(OutCeiling_dB))) / 20.0);
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            for (int s = 0; s < numSamples; s++)
+            {
+                double x = double(channels[channel][s]) / Ceiling;
+                double t = std::abs(x);
+                double y = t;
+                if (1.15 <= t) y = 1.0;
+                else if (.85 < t) y = t - ((t - .85) * (t - .85) / .6);
+                channels[channel][s] = float(std::copysign(y * Ceiling, x));
+            }
+        }
+    }
+}
+
+//R2.20 The VOX vowel table. OO -> OH -> AH -> EH -> EE, Q narrows the formants.
+void MakoReferenceChain::Mako_Vox_Table()
+{
+    const double VowelFreq[5][Vox_Formants] = {
+        { 300.0,  870.0, 2240.0, 3300.0 },
+        { 570.0,  840.0, 2410.0, 3300.0 },
+        { 730.0, 1090.0, 2440.0, 3400.0 },
+        { 530.0, 1840.0, 2480.0, 3500.0 },
+        { 270.0, 2290.0, 3010.0, 3700.0 },
+    };
+    const double VowelLevel[Vox_Formants] = { 1.0, .6, .25, .1 };
+
+    Vox_Q = Setting[MakoSmackTalkCore::e_Q];
+    double Qf = 3.0 + (double(Vox_Q) * 17.0);
+
+    for (int t = 0; t < Vox_TableSize; t++)
+    {
+        double pos = double(t) * 4.0 / double(Vox_TableSize - 1);
+        int v = std::min(3, int(pos));
+        double frac = pos - double(v);
+
+        for (int f = 0; f < Vox_Formants; f++)
+        {
+            double Fc = std::min(SampleRate * .45, VowelFreq[v][f] + (VowelFreq[v + 1][f] - VowelFreq[v][f]) * frac);
+
+            //R2.20 Constant peak gain bandpass, with x2 makeup gain.
+            double w0 = 6.283185307179586 * Fc / SampleRate;
+            double alpha = std::sin(w0) / (2.0 * Qf);
+            double dd = 1.0 / (1.0 + alpha);
+            Vox_A0[t][f] = 2.0 * VowelLevel[f] * alpha * dd;
+            Vox_B1[t][f] = -2.0 * std::cos(w0) * dd;
+            Vox_B2[t][f] = (1.0 - alpha) * dd;
+        }
+    }
+}
+
+//R2.20 One sample through a latency delay. x goes in, the one from Lookahead samples ago comes out.
+double MakoReferenceChain::Mako_Delay(double x, int line)
+{
+    std::vector<double>& d = Dly[line];
+    d[size_t(Dly_Pos[line])] = x;
+    Dly_Pos[line] = (Dly_Pos[line] + 1) % int(d.size());
+    return d[size_t(Dly_Pos[line])];
+}
+
+//R2.20 One sample through the whole chain. Link is what the envelope hears with LINK or KEY (-1 = this channel).
+double MakoReferenceChain::Mako_Sample(double x, int channel, double Link)
+{
+    const double Gain = Setting[MakoSmackTalkCore::e_Gain];
+    const double NGate = Setting[MakoSmackTalkCore::e_NGate];
+    const double Sense = Setting[MakoSmackTalkCore::e_Sense];
+    const double Q = Setting[MakoSmackTalkCore::e_Q];
+    const double Mix = Setting[MakoSmackTalkCore::e_Mix];
+    const int Mode = int(Setting[MakoSmackTalkCore::e_Mode]);
+
+    //R2.20 NOISE GATE. The envelope sees the input before the gate.
+    double In = (0.0 <= Link) ? Link : std::abs(x);
+    Signal_AVG[channel] = (Signal_AVG[channel] * (1.0 - Env_Coef)) + (In * Env_Coef);
+    if (.0001 <= NGate) x *= std::min(1.0, Signal_AVG[channel] * 10000.0 * (1.1 - NGate));
+
+    //R2.20 LATENCY.
+    x = Mako_Delay(x, channel);
+
+    if (Mix < .001) return x;
+
+    //R2.20 How far the envelope pushes the filters. Same for WAH, VOX and TRACK.
+    double tFac = std::min(.90, Signal_AVG[channel] * 500.0 * (Sense * Sense));
+
+    double Wet = 0.0;
+    if (Mode == MakoSmackTalkCore::e_ModeSmack)
+    {
+        //R2.20 SMACK. sin(x * fac), gain balanced by 1.5 / fac.
+        double Fac = 1.0 + Sense * 50.0;
+        Wet = std::sin(x * Fac) * (1.5 / Fac);
+    }
+    else if (Mode == MakoSmackTalkCore::e_ModeVox)
+    {
+        //R2.20 VOX. The envelope picks a spot in the vowel table, the two closest entries are blended.
+        double pos = std::max(0.0, tFac * (double(Vox_TableSize - 1) / .90));
+        int idx = std::min(Vox_TableSize - 2, int(pos));
+        double frac = pos - double(idx);
+
+        double xd = x - Vox_xn2[channel];
+        for (int f = 0; f < Vox_Formants; f++)
+        {
+            double a0 = Vox_A0[idx][f] + (Vox_A0[idx + 1][f] - Vox_A0[idx][f]) * frac;
+            double b1 = Vox_B1[idx][f] + (Vox_B1[idx + 1][f] - Vox_B1[idx][f]) * frac;
+            double b2 = Vox_B2[idx][f] + (Vox_B2[idx + 1][f] - Vox_B2[idx][f]) * frac;
+
+            double y = a0 * xd - b1 * Vox_yn1[channel][f] - b2 * Vox_yn2[channel][f];
+            Vox_yn2[channel][f] = Vox_yn1[channel][f];
+            Vox_yn1[channel][f] = y;
+            Wet += y;
+        }
+        Vox_xn2[channel] = Vox_xn1[channel];
+        Vox_xn1[channel] = x;
+    }
+    else
+    {
+        //R2.20 WAH. New coeffs every sample from the envelope.
+        tFac = std::max(.0001, tFac);
+        double Fc = 800.0 * (.1 + tFac);
+        double BW = 1.4 * (.1 + tFac * 3.0);
+
+        //R2.20 TRACK. The center is blended towards the note times Ratio, the last note is held.
+        if (Mode == MakoSmackTalkCore::e_ModeTrack)
+        {
+            if (0.0f < Pitch[channel].Pitch)
+                Fc += (double(Pitch[channel].Pitch) * Setting[MakoSmackTalkCore::e_Ratio] - Fc) * Setting[MakoSmackTalkCore::e_Track];
+            Fc = std::min(SampleRate * .45, std::max(40.0, Fc));
+        }
+
+        double Gain_dB = Q * 30.0;
+        double K = 6.283185307179586 * (Fc * .5) / SampleRate;
+        double K2 = K * K;
+        double V0 = std::pow(10.0, Gain_dB / 20.0);
+        double dd = 1.0 / (1.0 + K / BW + K2);
+        double a0 = (1.0 + (V0 * K) / BW + K2) * dd;
+        double a1 = (2.0 * (K2 - 1.0)) * dd;
+        double a2 = (1.0 - (V0 * K) / BW + K2) * dd;
+        double b1 = a1;
+        double b2 = (1.0 - K / BW + K2) * dd;
+
+        Wet = a0 * x + a1 * xn1[channel] + a2 * xn2[channel] - b1 * yn1[channel] - b2 * yn2[channel];
+        xn2[channel] = xn1[channel]; xn1[channel] = x;
+        yn2[channel] = yn1[channel]; yn1[channel] = Wet;
+    }
+
+    //R2.80 EQUAL POWER dry/wet (the OUTPUT STAGE). Changed on purpose, see 2.80 in the README.
+    return (x * std::sqrt(1.0 - Mix)) + (Wet * Gain * std::sqrt(Mix));
+}
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    Mako_Reference.h
+    R2.20 FROZEN REFERENCE. A plain, one sample at a time copy of the whole
+    effect as it sounds today: NOISE GATE, SMACK, TALK (WAH), VOX, TRACK,
+    LINK and KEY detection, FORCE MONO, the dry/wet mix, the OUTPUT SAFETY
+    soft clipper and BYPASS. No block kernels, no control rate and no
+    oversampling. Math is done in double so rounding is not an issue.
+
+    Left out on purpose: the CAB IR (it has its own impulse test), MODE FADE
+    and the BYPASS fade (the reference starts in its mode and stays there).
+    TRACK uses the plugin's own pitch detector (Mako_Pitch.h), fed in the
+    same pieces as the core, so the reference checks how the note moves the
+    filter, not how the note is found.
+
+    The golden render suite (Mako_Golden.h) compares every optimized path
+    against this. Do NOT optimize or "fix" this file. If the sound is meant to
+    change, change it on purpose and say so in the README VERSION list.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Mako_Core.h"
+
+class MakoReferenceChain
+{
+public:
+    //R2.20 Lookahead is the core's latency (getLatencySamples). The core runs the
+    //R2.20 envelope and gate before its latency delay, so the WAH hears the
+    //R2.20 envelope that many samples early. The reference does the same.
+    void prepare(double sampleRate, int Lookahead);
+    void reset();
+
+    //R2.20 Same layout as MakoSmackTalkCore::process, key is the SIDECHAIN.
+    //R2.20 Call it with the same block sizes as the core, TRACK's pitch detector is fed in the same pieces.
+    void process(float* const* channels, int numChannels, int numSamples, float* const* key = nullptr, int numKeyChannels = 0);
+
+    //R2.20 Every setting (e_Gain to e_Detect), same as the core.
+    float Setting[MakoSmackTalkCore::e_Detect + 1] = {};
+
+    //R2.20 Same as the core's. BYPASS is held for the whole render, there is no fade.
+    bool OutClip = false;
+    float OutCeiling_dB = -.3f;
+    bool Bypass = false;
+
+private:
+    double SampleRate = 48000.0;
+    double Env_Coef = .005;
+
+    //R2.20 The core's micro block. TRACK's pitch detector is fed one piece of it at a time.
+    int Micro_Size = 64;
+    int Micro_Pos = 0;
+
+    //R2.20 Per channel state.
+    double Signal_AVG[2] = {};
+    double xn1[2] = {}, xn2[2] = {}, yn1[2] = {}, yn2[2] = {};
+    MakoPitch Pitch[2];
+
+    //R2.20 VOX formant bank. The vowel table is part of the sound, so it is copied too (in double).
+    static const int Vox_Formants = 4;
+    static const int Vox_TableSize = 64;
+    double Vox_A0[Vox_TableSize][Vox_Formants] = {};
+    double Vox_B1[Vox_TableSize][Vox_Formants] = {};
+    double Vox_B2[Vox_TableSize][Vox_Formants] = {};
+    float Vox_Q = -1.0f;
+    double Vox_xn1[2] = {}, Vox_xn2[2] = {};
+    double Vox_yn1[2][Vox_Formants] = {}, Vox_yn2[2][Vox_Formants] = {};
+
+    //R2.20 Latency delays. 0 and 1 are the gated signal, 2 and 3 the untouched input for BYPASS.
+    std::vector<double> Dly[4];
+    int Dly_Pos[4] = {};
+
+    void Mako_Vox_Table();
+    double Mako_Delay(double x, int line);
+    double Mako_Sample(double x, int channel, double Link);
+};
@@ -0,0 +1,237 @@
+/*
+  ==============================================================================
+
+    Mako_Stress.cpp
+    R2.10 WORST CASE STRESS TEST. See Mako_Stress.h.
+
+  ==============================================================================
+*/
+
+#include "Mako_Stress.h"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+juce::uint64 Mako_Stress_Cycles()
+{
+   #if JUCE_INTEL
+    return juce::uint64(__rdtsc());
+   #else
+    static const double Scale = double(juce::SystemStats::getCpuSpeedInMegahertz()) * 1.0e6
+                              / double(juce::Time::getHighResolutionTicksPerSecond());
+    return juce::uint64(double(juce::Time::getHighResolutionTicks()) * Scale);
+   #endif
+}
+
+namespace
+{
+    //R2.10 The kinds of input we throw at the plugin.
+    enum { e_SigSilence, e_SigSine, e_SigNoise, e_SigStep, e_SigDecay, e_SigDenormal, e_SigNaN, e_SigCount, };
+    const char* const Sig_Names[e_SigCount] = { "silence", "sine", "noise", "silence to full scale", "decaying tail", "denormals", "NaN/Inf" };
+
+    //R2.10 Knob parameters, in e_Gain... order. The editor copies these into Setting[], so we do too.
+    const char* const Knob_IDs[] = { "gain", "ngate", "sense", "q", "mix", "mode", "mono" };
+
+    const double Rates[] = { 22050.0, 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0, 384000.0 };
+    const int MaxBlocks[] = { 32, 64, 128, 256, 441, 512, 1024, 2048 };
+
+    //R2.10 What one block did. Kept so the worst and first failed blocks can be described.
+    struct tp_block_info
+    {
+        int Index;
+        int Samples;
+        int Signal;
+        double Rate;
+        bool Storm;
+        bool AfterPrepare;
+        bool Offline;
+        int Mode;
+        int Quality;
+        double Cycles;
+    };
+
+    juce::String Mako_Stress_Describe(const tp_block_info& b)
+    {
+        juce::String s = "block " + juce::String(b.Index) + ": " + juce::String(b.Samples) + " samples at "
+                       + juce::String(b.Rate) + "Hz, " + Sig_Names[b.Signal] + ", mode " + juce::String(b.Mode)
+                       + ", quality " + juce::String(b.Quality) + ", " + juce::String(b.Cycles / double(b.Samples)) + " cycles/sample";
+        if (b.Storm) s += ", automation storm";
+        if (b.AfterPrepare) s += ", first block after prepareToPlay";
+        if (b.Offline) s += ", offline";
+        return s;
+    }
+
+    bool Mako_Stress_Finite(const juce::AudioBuffer<float>& Buf, int Channels, int num)
+    {
+        for (int channel = 0; channel < Channels; channel++)
+        {
+            const float* d = Buf.getReadPointer(channel);
+            for (int s = 0; s < num; s++)
+                if (!std::isfinite(d[s])) return false;
+        }
+        return true;
+    }
+}
+
+bool Mako_Stress_Run(MakoBiteAudioProcessor& Proc, const tp_stress_config& Config, tp_stress_result& Result)
+{
+    Result = tp_stress_result();
+    juce::Random Rand(Config.Seed);
+
+    std::atomic<float>* Knobs[MakoBiteAudioProcessor::e_Mono + 1] = {};
+    for (int k = 0; k <= MakoBiteAudioProcessor::e_Mono; k++) Knobs[k] = Proc.parameters.getRawParameterValue(Knob_IDs[k]);
+    auto* Quality = Proc.parameters.getRawParameterValue("quality");
+    auto* Mode = Proc.parameters.getParameter("mode");
+
+    //R2.10 One buffer as big as the biggest block we ever ask for. Blocks are views into it.
+    const int Channels = juce::jmax(1, juce::jmax(Proc.getTotalNumInputChannels(), Proc.getTotalNumOutputChannels()));
+    juce::AudioBuffer<float> Buf(Channels, 2048);
+    juce::MidiBuffer Midi;
+
+    double Rate = 48000.0;
+    int MaxBlock = 512;
+    auto Prepare = [&]()
+    {
+        Proc.setRateAndBufferSizeDetails(Rate, MaxBlock);
+        Proc.prepareToPlay(Rate, MaxBlock);
+    };
+    Prepare();
+
+    //R2.10 Signal state carried from block to block.
+    double Phase = 0.0, Freq = 220.0;
+    float Level = .5f;
+    bool AfterPrepare = true;
+
+    std::vector<float> Costs;
+    Costs.reserve(size_t(juce::jmax(0, Config.Blocks)));
+    double Total_Cycles = 0.0;
+
+    for (int b = 0; b < Config.Blocks; b++)
+    {
+        //R2.10 Sample rate and block size changes.
+        if ((0 < Config.Rate_Change_Every) && (0 < b) && ((b % Config.Rate_Change_Every) == 0))
+        {
+            Rate = Rates[Rand.nextInt(int(std::size(Rates)))];
+            MaxBlock = MaxBlocks[Rand.nextInt(int(std::size(MaxBlocks)))];
+            Prepare();
+            AfterPrepare = true;
+        }
+
+        //R2.10 Block size. 1, odd, full and random sizes.
+        int num;
+        switch (Rand.nextInt(8))
+        {
+        case 0:  num = 1; break;
+        case 1:  num = juce::jmin(MaxBlock, 1 + 2 * Rand.nextInt(32)); break;
+        case 2:  num = MaxBlock; break;
+        default: num = 1 + Rand.nextInt(MaxBlock); break;
+        }
+
+        //R2.10 Automation. Sometimes every parameter at once, sometimes only the mode.
+        bool Storm = (Rand.nextInt(4) == 0);
+        if (Storm)
+        {
+            for (auto* p : Proc.getParameters()) p->setValue(Rand.nextFloat());
+        }
+        else if ((Mode != nullptr) && (Rand.nextInt(20) == 0))
+        {
+            Mode->setValue(Rand.nextFloat());
+        }
+        if (Rand.nextInt(200) == 0) Proc.setNonRealtime(!Proc.isNonRealtime());
+
+        for (int k = 0; k <= MakoBiteAudioProcessor::e_Mono; k++)
+            if (Knobs[k] != nullptr) Proc.Setting[k] = Knobs[k]->load();
+        Proc.SettingsChanged += 1;
+
+        //R2.10 Input.
+        int Signal = Rand.nextInt(e_SigCount);
+        if ((Signal == e_SigSine) || (Signal == e_SigStep)) Freq = 40.0 + 2000.0 * double(Rand.nextFloat());
+        if (Signal != e_SigDecay) Level = Rand.nextFloat();
+
+        for (int channel = 0; channel < Channels; channel++)
+        {
+            float* d = Buf.getWritePointer(channel);
+            double ph = Phase;
+            float lv = Level;
+            for (int s = 0; s < num; s++)
+            {
+                ph += Freq / Rate;
+                float sine = float(std::sin(6.283185307 * ph));
+                switch (Signal)
+                {
+                case e_SigSilence:  d[s] = 0.0f; break;
+                case e_SigSine:     d[s] = lv * sine; break;
+                case e_SigNoise:    d[s] = Rand.nextFloat() * 2.0f - 1.0f; break;
+                case e_SigStep:     d[s] = (s < num / 2) ? 0.0f : ((0.0f <= sine) ? 1.0f : -1.0f); break;
+                case e_SigDecay:    d[s] = lv * sine; lv *= .999f; break;
+                case e_SigDenormal: d[s] = ((s & 1) ? 1.0e-39f : -1.0e-40f) * (1.0f + sine); break;
+                default:            d[s] = sine; break;
+                }
+            }
+
+            if (Signal == e_SigNaN)
+            {
+                const float Bad[] = { std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity() };
+                for (int n = 0; n < 3; n++) d[Rand.nextInt(num)] = Bad[n];
+            }
+
+            if (channel == (Channels - 1))
+            {
+                Phase = ph - std::floor(ph);
+                Level = lv;
+            }
+        }
+
+        //R2.10 The timed part. Only the host call.
+        juce::AudioBuffer<float> Block(Buf.getArrayOfWritePointers(), Channels, num);
+        int Violations = Mako_RT_Violations();
+
+        auto c0 = Mako_Stress_Cycles();
+        Proc.processBlock(Block, Midi);
+        double Cycles = double(Mako_Stress_Cycles() - c0);
+
+        //R2.10 Score the block.
+        tp_block_info Info = { b, num, Signal, Rate, Storm, AfterPrepare, Proc.isNonRealtime(),
+                               int(Proc.Setting[MakoBiteAudioProcessor::e_Mode]), (Quality != nullptr) ? int(Quality->load()) : -1, Cycles };
+        AfterPrepare = false;
+
+        double PerSample = Cycles / double(num);
+        Costs.push_back(float(PerSample));
+        Total_Cycles += Cycles;
+        Result.Blocks++;
+        Result.Samples += num;
+
+        if (Result.Max_CyclesPerSample < PerSample)
+        {
+            Result.Max_CyclesPerSample = PerSample;
+            Result.Worst = Mako_Stress_Describe(Info);
+        }
+        Result.Max_BlockCycles = juce::jmax(Result.Max_BlockCycles, Cycles);
+
+        bool Failed = false;
+        if ((Config.Budget_Block + Config.Budget_Sample * double(num)) < Cycles) { Result.Budget_Fails++; Failed = true; }
+        if (!Mako_Stress_Finite(Buf, Channels, num)) { Result.NonFinite_Blocks++; Failed = true; }
+        if (Violations != Mako_RT_Violations()) { Result.RT_Violations += Mako_RT_Violations() - Violations; Failed = true; }
+        if (Failed && Result.First_Fail.isEmpty()) Result.First_Fail = Mako_Stress_Describe(Info);
+    }
+
+    //R2.10 Tail of the cost curve.
+    if (!Costs.empty())
+    {
+        size_t n = juce::jmin(Costs.size() - 1, size_t(double(Costs.size()) * .999));
+        std::nth_element(Costs.begin(), Costs.begin() + std::ptrdiff_t(n), Costs.end());
+        Result.P999_CyclesPerSample = Costs[n];
+        Result.Avg_CyclesPerSample = Total_Cycles / double(juce::jmax(juce::int64(1), Result.Samples));
+    }
+
+    return Result.Passed();
+}
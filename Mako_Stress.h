@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    Mako_Stress.h
+    R2.10 WORST CASE STRESS TEST. Dropouts come from the slowest block, not
+    the average one. This drives processBlock() with everything a host can
+    throw at it and records the most expensive blocks:
+      - random block sizes, including 1 and odd sizes
+      - automation storms on every parameter (and mode and quality switches)
+      - silence to full scale steps, loud noise, decaying tails
+      - NaN, Inf and denormal samples
+      - sample rate and block size changes through prepareToPlay()
+      - realtime/offline switches (offline can force the HIGH tier)
+
+    Every block is timed in CPU cycles. A block fails if it takes more than
+    Budget_Block + Budget_Sample x samples cycles, if it puts out NaN/Inf, or
+    if the MAKO_RT_CHECK build saw an allocation or lock.
+
+    Call Mako_Stress_Run() from a test program (see Tools/MakoStress). It
+    takes a while, never call it from a host.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+struct tp_stress_config
+{
+    int Blocks = 200000;                //R2.10 Blocks to run.
+    juce::int64 Seed = 1;               //R2.10 Same seed = same run.
+    int Rate_Change_Every = 5000;       //R2.10 Blocks between prepareToPlay() calls (0 = never).
+
+    //R2.10 Cycle budget. Block cost is allowed to be Budget_Block + Budget_Sample x samples.
+    //R2.10 Budget_Block covers the fixed cost of a block (settings, tier, the staged pitch check).
+    //R2.10 These defaults are loose. Tighten them for your release machine.
+    double Budget_Block = 150000.0;
+    double Budget_Sample = 3000.0;
+};
+
+struct tp_stress_result
+{
+    int Blocks = 0;
+    juce::int64 Samples = 0;
+
+    double Max_CyclesPerSample = 0.0;   //R2.10 Worst block cost divided by its size.
+    double Max_BlockCycles = 0.0;       //R2.10 Worst block cost.
+    double P999_CyclesPerSample = 0.0;  //R2.10 99.9% of blocks were cheaper than this.
+    double Avg_CyclesPerSample = 0.0;
+
+    int Budget_Fails = 0;
+    int NonFinite_Blocks = 0;           //R2.10 Blocks that put out NaN or Inf.
+    int RT_Violations = 0;              //R2.10 Only counted in MAKO_RT_CHECK builds.
+
+    juce::String Worst;                 //R2.10 What the most expensive block was doing.
+    juce::String First_Fail;            //R2.10 What the first failed block was doing.
+
+    bool Passed() const { return (Budget_Fails == 0) && (NonFinite_Blocks == 0) && (RT_Violations == 0); }
+};
+
+//R2.10 Run the stress test on a processor. Returns Result.Passed().
+bool Mako_Stress_Run(MakoBiteAudioProcessor& Proc, const tp_stress_config& Config, tp_stress_result& Result);
+
+//R2.10 CPU cycle counter. The time stamp counter on x86, ticks scaled by the CPU speed everywhere else.
+juce::uint64 Mako_Stress_Cycles();
@@ -0,0 +1,286 @@
+/*
+  ==============================================================================
+
+    Mako_Sweep.cpp
+    R2.60 PARAMETER SWEEP RENDERER. See Mako_Sweep.h.
+
+  ==============================================================================
+*/
+
+#include "Mako_Sweep.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+    //R2.60 The knob parameters we set, in e_Gain... order. The editor copies these into Setting[], so we do too.
+    const char* const Knob_IDs[] = { "gain", "ngate", "sense", "q", "mix", "mode", "mono" };
+
+    //R2.60 What each worker thread owns. Nothing in here is shared.
+    struct tp_sweep_worker
+    {
+        std::unique_ptr<MakoBiteAudioProcessor> Proc;
+        juce::AudioBuffer<float> Buf;       //R2.60 One block. The input is copied in a block at a time and processed in place.
+        std::unique_ptr<juce::dsp::FFT> Fft;
+        std::vector<float> Frame;           //R2.60 Mono output waiting for the next centroid.
+        std::vector<float> Work;            //R2.60 FFT work area (2 x frame).
+        std::vector<float> Window;
+    };
+
+    //R2.60 Build the points. The grid is every combination, Random picks that many points inside the grid's range.
+    void Mako_Sweep_Points(const tp_sweep_config& Config, std::vector<tp_sweep_point>& Points)
+    {
+        Points.clear();
+        if (Config.Sense.isEmpty() || Config.Q.isEmpty() || Config.Gain.isEmpty() || Config.Modes.isEmpty()) return;
+
+        if (Config.Random <= 0)
+        {
+            for (int m : Config.Modes)
+                for (float Sense : Config.Sense)
+                    for (float Q : Config.Q)
+                        for (float Gain : Config.Gain)
+                            Points.push_back({ Sense, Q, Gain, m });
+            return;
+        }
+
+        auto Pick = [](juce::Random& Rand, const juce::Array<float>& Values)
+        {
+            float Lo = *std::min_element(Values.begin(), Values.end());
+            float Hi = *std::max_element(Values.begin(), Values.end());
+            return Lo + (Hi - Lo) * Rand.nextFloat();
+        };
+
+        juce::Random Rand(Config.Seed);
+        for (int p = 0; p < Config.Random; p++)
+        {
+            float Sense = Pick(Rand, Config.Sense);
+            float Q = Pick(Rand, Config.Q);
+            float Gain = Pick(Rand, Config.Gain);
+            Points.push_back({ Sense, Q, Gain, Config.Modes[Rand.nextInt(Config.Modes.size())] });
+        }
+    }
+
+    //R2.60 Set the processor's knobs the way a host would, then copy them into Setting[] like the editor does.
+    void Mako_Sweep_Set(MakoBiteAudioProcessor& Proc, const tp_sweep_point& p)
+    {
+        auto Set = [&Proc](const char* ID, float Value)
+        {
+            if (auto* Parm = Proc.parameters.getParameter(ID)) Parm->setValue(Parm->convertTo0to1(Value));
+        };
+        Set("sense", p.Sense);
+        Set("q", p.Q);
+        Set("gain", p.Gain);
+        Set("mode", float(p.Mode));
+
+        for (int k = 0; k <= MakoBiteAudioProcessor::e_Mono; k++)
+            if (auto* Raw = Proc.parameters.getRawParameterValue(Knob_IDs[k])) Proc.Setting[k] = Raw->load();
+        Proc.SettingsChanged += 1;
+    }
+
+    //R2.60 Spectral centroid of the worker's full frame in Hz. 0 if the frame is silent.
+    float Mako_Sweep_Centroid(tp_sweep_worker& W, double Rate)
+    {
+        const int Size = int(W.Frame.size());
+        for (int s = 0; s < Size; s++) W.Work[size_t(s)] = W.Frame[size_t(s)] * W.Window[size_t(s)];
+        std::fill(W.Work.begin() + Size, W.Work.end(), 0.0f);
+        W.Fft->performFrequencyOnlyForwardTransform(W.Work.data());
+
+        double Sum = 0.0, Weighted = 0.0;
+        for (int k = 1; k <= Size / 2; k++)
+        {
+            Sum += W.Work[size_t(k)];
+            Weighted += double(W.Work[size_t(k)]) * double(k);
+        }
+        if (Sum < 1.0e-9) return 0.0f;
+        return float(Weighted / Sum * Rate / double(Size));
+    }
+
+    //R2.60 Render one point against one corpus item. The output is measured as it comes out, block by block.
+    void Mako_Sweep_Render(tp_sweep_worker& W, const tp_sweep_config& Config, const tp_sweep_point& p,
+                           const juce::AudioBuffer<float>& In, int Index, tp_sweep_render& Out)
+    {
+        auto Ticks = juce::Time::getHighResolutionTicks();
+        auto& Proc = *W.Proc;
+        const int Block = W.Buf.getNumSamples();
+        juce::MidiBuffer Midi;
+
+        //R2.60 prepareToPlay clears everything the last render left behind (filters, delay, envelope).
+        Mako_Sweep_Set(Proc, p);
+        Proc.prepareToPlay(Config.SampleRate, Block);
+
+        //R2.60 One block of silence first, so SMACK has finished ramping in from its default factor.
+        W.Buf.clear();
+        Proc.processBlock(W.Buf, Midi);
+
+        std::unique_ptr<juce::AudioFormatWriter> Writer;
+        if (Config.Audio_Dir != juce::File())
+        {
+            auto File = Config.Audio_Dir.getChildFile("sweep_" + juce::String(Index).paddedLeft('0', 5) + ".wav");
+            File.deleteFile();
+            if (auto Stream = File.createOutputStream())
+            {
+                juce::WavAudioFormat Wav;
+                Writer.reset(Wav.createWriterFor(Stream.get(), Config.SampleRate, 2, 24, {}, 0));
+                if (Writer != nullptr) Stream.release();
+            }
+        }
+
+        //R2.60 The latency is skipped at the start and rendered as silence at the end, so the output lines up with the input.
+        const int N = In.getNumSamples();
+        const int Latency = Proc.getLatencySamples();
+        const int Total = N + Latency;
+        const int Size = int(W.Frame.size());
+        int Fill = 0;
+        double SumSq = 0.0;
+        float Peak = 0.0f;
+
+        Out.Centroid.clear();
+        Out.Centroid.reserve(size_t(N / Size + 1));
+
+        for (int start = 0; start < Total; start += Block)
+        {
+            int num = juce::jmin(Block, Total - start);
+            int have = juce::jlimit(0, num, N - start);
+
+            juce::AudioBuffer<float> Buf(W.Buf.getArrayOfWritePointers(), W.Buf.getNumChannels(), num);
+            Buf.clear();
+            for (int channel = 0; channel < 2; channel++)
+                if (0 < have) Buf.copyFrom(channel, 0, In, channel, start, have);
+
+            Proc.processBlock(Buf, Midi);
+
+            //R2.60 Only the part after the latency is the real output.
+            int skip = juce::jlimit(0, num, Latency - start);
+            if (num <= skip) continue;
+
+            const float* L = Buf.getReadPointer(0) + skip;
+            const float* R = Buf.getReadPointer(1) + skip;
+            const int count = num - skip;
+
+            for (int s = 0; s < count; s++)
+            {
+                SumSq += double(L[s]) * double(L[s]) + double(R[s]) * double(R[s]);
+                Peak = juce::jmax(Peak, std::abs(L[s]), std::abs(R[s]));
+
+                W.Frame[size_t(Fill++)] = .5f * (L[s] + R[s]);
+                if (Fill == Size)
+                {
+                    Out.Centroid.push_back(Mako_Sweep_Centroid(W, Config.SampleRate));
+                    Fill = 0;
+                }
+            }
+
+            if (Writer != nullptr)
+            {
+                const float* Chans[2] = { L, R };
+                Writer->writeFromFloatArrays(Chans, 2, count);
+            }
+        }
+
+        Out.Rms_dB = juce::Decibels::gainToDecibels(float(std::sqrt(SumSq / double(juce::jmax(1, N * 2)))), -300.0f);
+        Out.Peak_dB = juce::Decibels::gainToDecibels(Peak, -300.0f);
+
+        double Sum = 0.0;
+        int Count = 0;
+        for (float c : Out.Centroid)
+            if (0.0f < c) { Sum += c; Count++; }
+        Out.Centroid_Hz = (0 < Count) ? float(Sum / double(Count)) : 0.0f;
+        Out.Seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - Ticks);
+    }
+}
+
+bool Mako_Sweep_Run(const tp_sweep_config& Config, tp_sweep_result& Result)
+{
+    Result = tp_sweep_result();
+    auto Ticks = juce::Time::getHighResolutionTicks();
+
+    //R2.60 Load the corpus once. Every worker reads the same buffers, nobody writes to them.
+    std::vector<juce::AudioBuffer<float>> Items;
+    juce::AudioFormatManager Formats;
+    Formats.registerBasicFormats();
+    for (const auto& f : Config.Files)
+    {
+        std::unique_ptr<juce::AudioFormatReader> Reader(Formats.createReaderFor(f));
+        if ((Reader == nullptr) || (Reader->lengthInSamples < 1)) continue;
+
+        Items.emplace_back(2, int(Reader->lengthInSamples));
+        Reader->read(&Items.back(), 0, Items.back().getNumSamples(), 0, true, true);
+        Result.Items.add(f.getFileName());
+    }
+    if (Items.empty()) return false;
+
+    Mako_Sweep_Points(Config, Result.Points);
+    const int Total = int(Result.Points.size() * Items.size());
+    Result.Renders.resize(size_t(Total));
+    if (Config.Audio_Dir != juce::File()) Config.Audio_Dir.createDirectory();
+
+    //R2.60 One processor per worker. They are made here, on the calling thread, and handed out.
+    int Threads = (0 < Config.Threads) ? Config.Threads : juce::SystemStats::getNumCpus();
+    Threads = juce::jlimit(1, juce::jmax(1, Total), Threads);
+    Result.Threads = Threads;
+
+    const int Block = juce::jmax(1, Config.BlockSize);
+    const int Frame_Order = juce::jlimit(6, 15, Config.Frame_Order);
+    const int Size = 1 << Frame_Order;
+
+    std::vector<tp_sweep_worker> Workers(static_cast<size_t>(Threads));
+    for (auto& W : Workers)
+    {
+        W.Proc = std::make_unique<MakoBiteAudioProcessor>();
+        W.Proc->setNonRealtime(true);
+        W.Proc->setRateAndBufferSizeDetails(Config.SampleRate, Block);
+        W.Buf.setSize(juce::jmax(2, W.Proc->getTotalNumInputChannels(), W.Proc->getTotalNumOutputChannels()), Block);
+        W.Fft = std::make_unique<juce::dsp::FFT>(Frame_Order);
+        W.Frame.assign(size_t(Size), 0.0f);
+        W.Work.assign(size_t(Size * 2), 0.0f);
+        W.Window.resize(size_t(Size));
+        for (int s = 0; s < Size; s++) W.Window[size_t(s)] = .5f - .5f * std::cos(6.2831853f * float(s) / float(Size));
+    }
+
+    //R2.60 Each worker takes the next render number until there are none left. Render r is point r / items, item r % items,
+    //R2.60 so the result does not depend on which thread did what.
+    std::atomic<int> Next { 0 };
+    auto Work = [&](tp_sweep_worker& W)
+    {
+        for (int r = Next++; r < Total; r = Next++)
+        {
+            auto& Out = Result.Renders[size_t(r)];
+            Out.Point = r / int(Items.size());
+            Out.Item = r % int(Items.size());
+            Mako_Sweep_Render(W, Config, Result.Points[size_t(Out.Point)], Items[size_t(Out.Item)], r, Out);
+        }
+    };
+
+    std::vector<std::thread> Pool;
+    for (int t = 1; t < Threads; t++) Pool.emplace_back(Work, std::ref(Workers[size_t(t)]));
+    Work(Workers[0]);
+    for (auto& t : Pool) t.join();
+
+    Result.Seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - Ticks);
+    return true;
+}
+
+bool Mako_Sweep_Write(const tp_sweep_result& Result, const juce::File& Csv)
+{
+    Csv.deleteFile();
+    juce::FileOutputStream Out(Csv);
+    if (!Out.openedOk()) return false;
+
+    Out << "render,item,mode,sense,q,gain,rms_db,peak_db,centroid_hz,centroid_track\n";
+    for (size_t r = 0; r < Result.Renders.size(); r++)
+    {
+        const auto& R = Result.Renders[r];
+        const auto& p = Result.Points[size_t(R.Point)];
+
+        juce::String Track;
+        for (float c : R.Centroid) Track << juce::String(juce::roundToInt(c)) << " ";
+
+        Out << juce::String(int(r)) << "," << "\"" << Result.Items[R.Item] << "\","  << juce::String(p.Mode) << ","
+            << juce::String(p.Sense, 3) << "," << juce::String(p.Q, 3) << "," << juce::String(p.Gain, 3) << ","
+            << juce::String(R.Rms_dB, 2) << "," << juce::String(R.Peak_dB, 2) << "," << juce::String(R.Centroid_Hz, 1) << ","
+            << Track.trimEnd() << "\n";
+    }
+    return true;
+}
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    Mako_Sweep.h
+    R2.60 PARAMETER SWEEP RENDERER. Renders a grid (or a random sample) of
+    Sense x Q x Gain x Mode settings against a corpus of input files, so
+    presets can be picked by listening and by numbers instead of by turning
+    knobs in a DAW.
+
+    Every render goes through a real MakoBiteAudioProcessor (processBlock),
+    so it sounds exactly like the plugin. Renders are spread over a pool of
+    worker threads. Each worker owns one processor and one block sized work
+    buffer. The input files are loaded once and only read by the workers.
+
+    Each render gives a short summary:
+      - RMS and peak level (dB)
+      - spectral centroid per frame (how bright it is over time)
+    and can also write its audio to a WAV file.
+
+    Call Mako_Sweep_Run() from a tool (see Tools/MakoSweep). It can take a
+    long time, never call it from a host.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+struct tp_sweep_config
+{
+    double SampleRate = 48000.0;
+    int BlockSize = 256;
+    int Threads = 0;                    //R2.60 Worker threads. 0 = one per CPU core.
+
+    //R2.60 The input corpus (WAV/AIFF). Mono files are played into both channels.
+    juce::Array<juce::File> Files;
+
+    //R2.60 The grid. Every combination is rendered against every file.
+    juce::Array<float> Sense { .1f, .3f, .5f, .7f, .9f };
+    juce::Array<float> Q { .25f, .5f, .75f };
+    juce::Array<float> Gain { .5f, 1.0f, 2.0f };
+    juce::Array<int> Modes { MakoBiteAudioProcessor::e_ModeSmack, MakoBiteAudioProcessor::e_ModeTalk,
+                             MakoBiteAudioProcessor::e_ModeVox, MakoBiteAudioProcessor::e_ModeTrack };
+
+    //R2.60 Random > 0 renders that many random points instead of the grid. Sense, Q and Gain are picked
+    //R2.60 between the lowest and highest grid value, the mode from Modes. Same seed = same points.
+    int Random = 0;
+    juce::int64 Seed = 1;
+
+    //R2.60 Spectral centroid frame size (a power of 2). One centroid per frame.
+    int Frame_Order = 11;
+
+    //R2.60 If set, every render is also written here as sweep_<render>.wav (24 bit).
+    juce::File Audio_Dir;
+};
+
+//R2.60 One point of the grid.
+struct tp_sweep_point
+{
+    float Sense;
+    float Q;
+    float Gain;
+    int Mode;
+};
+
+//R2.60 The summary of one render (one point against one file).
+struct tp_sweep_render
+{
+    int Point = 0;                      //R2.60 Index into tp_sweep_result::Points.
+    int Item = 0;                       //R2.60 Index into tp_sweep_result::Items.
+    float Rms_dB = -300.0f;
+    float Peak_dB = -300.0f;
+    float Centroid_Hz = 0.0f;           //R2.60 Average of the frames that had sound.
+    std::vector<float> Centroid;        //R2.60 Centroid of every frame in Hz (0 = silent frame).
+    double Seconds = 0.0;               //R2.60 How long the render took.
+};
+
+struct tp_sweep_result
+{
+    std::vector<tp_sweep_point> Points;
+    juce::StringArray Items;            //R2.60 File names of the corpus.
+    std::vector<tp_sweep_render> Renders;
+    int Threads = 0;
+    double Seconds = 0.0;               //R2.60 Wall clock time of the whole sweep.
+};
+
+//R2.60 Render the sweep. Returns false if no input file could be read.
+bool Mako_Sweep_Run(const tp_sweep_config& Config, tp_sweep_result& Result);
+
+//R2.60 Write the summaries as CSV, one line per render. The centroid track is the last column (space separated Hz).
+bool Mako_Sweep_Write(const tp_sweep_result& Result, const juce::File& Csv);
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    Mako_Telemetry.h
+    R2.00 TELEMETRY. Every plugin instance publishes a small stats record to
+    a shared memory file, so one reader (Tools/MakoTop) can watch a whole
+    session without opening any editors.
+
+    The file holds a header and a fixed table of slots. Each instance claims
+    one slot when it is created and frees it when it is deleted. The audio
+    thread fills its slot once per block with a seqlock: Seq is odd while it
+    writes and even when done. A reader copies the slot and only keeps the
+    copy if Seq was even and did not change. The writer never waits for the
+    reader and makes no system calls.
+
+    This header is plain C++ (no JUCE) so the reader can use it too. Only add
+    fields to the end of tp_telemetry_data and bump Telemetry_Version.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(_WIN32)
+ #include <cstdlib>
+ #include <string>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#endif
+
+namespace MakoTelemetry
+{
+    //R2.00 File name. It lives in /tmp on Linux and macOS and in %TEMP% on Windows.
+    //R2.00 On Linux and macOS it is in a folder of its own per user (Segment_Folder).
+    //R2.00 The version is part of the name, so old and new builds never share a file.
+    static const char* const Segment_Name = "MakoSmackTalk.v1.telemetry";
+
+#if !defined(_WIN32)
+    //R2.00 The folder for the file on Linux and macOS. Only this user can use it, so nobody else can put a file
+    //R2.00 or a link there for us to write into, or make the file first so we can not open it.
+    //R2.00 XDG_RUNTIME_DIR is made that way by the system. Without it we use /tmp/MakoSmackTalk-<uid>: made
+    //R2.00 here if Create is true, and only used if it is a real folder that is ours and nobody else can get into.
+    //R2.00 Returns "" if the folder is there but not safe.
+    inline std::string Segment_Folder(bool Create)
+    {
+        const char* Run = std::getenv("XDG_RUNTIME_DIR");
+        if ((Run != nullptr) && (Run[0] == '/')) return std::string(Run);
+
+        std::string Dir = "/tmp/MakoSmackTalk-" + std::to_string(unsigned(getuid()));
+        if (Create) mkdir(Dir.c_str(), 0700);
+
+        //R2.00 lstat, so a link to some other folder is not followed.
+        struct stat st = {};
+        if (lstat(Dir.c_str(), &st) != 0) return Create ? std::string() : Dir;
+        if (!S_ISDIR(st.st_mode) || (st.st_uid != getuid()) || ((st.st_mode & 077) != 0)) return std::string();
+        return Dir;
+    }
+#endif
+
+    static const uint32_t Magic = 0x4D4B5354;      //R2.00 "MKST"
+    static const uint32_t Telemetry_Version = 1;
+    static const int Slot_Count = 256;
+
+    //R2.00 The stats. Written by the audio thread at the end of every block.
+    struct tp_telemetry_data
+    {
+        uint64_t Blocks;            //R2.00 Blocks processed. Stops moving when the instance is idle.
+        int32_t Mode;               //R2.00 e_Mode... (Smack/Talk/Vox/Track).
+        int32_t Tier;               //R2.00 e_Tier... (Eco/Standard/High).
+        int32_t BlockSize;          //R2.00 Samples in the last block.
+        float SampleRate;
+        float Block_Ns;             //R2.00 CPU time of the last block in nanoseconds.
+        float Block_Ns_Max;         //R2.00 Worst block since the slot was claimed.
+        float Envelope;             //R2.00 Envelope follower (Signal_AVG), loudest channel.
+        float Gate;                 //R2.00 Noise gate gain 0 (shut) to 1 (open). -1 = gate is off.
+        float Peak_Out;             //R2.00 Peak output level of the last block (1 = 0dBFS).
+        uint32_t Clips;             //R2.00 Blocks that went over 0dBFS.
+    };
+
+    //R2.00 One instance. 128 bytes so two instances never share a cache line.
+    struct alignas(128) tp_telemetry_slot
+    {
+        std::atomic<uint32_t> Owner;    //R2.00 Process id of the owner. 0 = free.
+        std::atomic<uint32_t> Seq;      //R2.00 Seqlock counter. Odd = being written.
+        tp_telemetry_data Data;
+    };
+
+    struct tp_telemetry_header
+    {
+        std::atomic<uint32_t> Magic;
+        uint32_t Version;
+        uint32_t Slot_Count;
+        uint32_t Slot_Size;
+    };
+
+    //R2.00 The whole file. The header gets its own 128 bytes too.
+    struct tp_telemetry_segment
+    {
+        alignas(128) tp_telemetry_header Header;
+        tp_telemetry_slot Slots[Slot_Count];
+    };
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "Telemetry needs lock free atomics.");
+    static_assert(sizeof(tp_telemetry_slot) == 128, "Telemetry slot layout changed.");
+
+    //R2.00 Writer side. Only the slot owner may call this.
+    inline void Mako_Telemetry_Write(tp_telemetry_slot& Slot, const tp_telemetry_data& Data)
+    {
+        uint32_t s = Slot.Seq.load(std::memory_order_relaxed);
+        Slot.Seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&Slot.Data, &Data, sizeof(Data));
+        Slot.Seq.store(s + 2, std::memory_order_release);
+    }
+
+    //R2.00 Reader side. Returns false if the writer was busy. Just try again later.
+    inline bool Mako_Telemetry_Read(const tp_telemetry_slot& Slot, tp_telemetry_data& Data)
+    {
+        uint32_t s1 = Slot.Seq.load(std::memory_order_acquire);
+        if ((s1 & 1) != 0) return false;
+        std::memcpy(&Data, &Slot.Data, sizeof(Data));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return (s1 == Slot.Seq.load(std::memory_order_relaxed));
+    }
+}
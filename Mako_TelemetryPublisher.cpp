@@ -0,0 +1,161 @@
+/*
+  ==============================================================================
+
+    Mako_TelemetryPublisher.cpp
+    R2.00 Plugin side of the TELEMETRY. See Mako_Telemetry.h.
+
+  ==============================================================================
+*/
+
+#include "Mako_TelemetryPublisher.h"
+
+#if JUCE_WINDOWS
+ #ifndef WIN32_LEAN_AND_MEAN
+  #define WIN32_LEAN_AND_MEAN
+ #endif
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+#else
+ #include <cerrno>
+ #include <fcntl.h>
+ #include <signal.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#endif
+
+using namespace MakoTelemetry;
+
+MakoTelemetryPublisher::MakoTelemetryPublisher()
+{
+    const juce::int64 Size = juce::int64(sizeof(tp_telemetry_segment));
+    juce::File f = Mako_Telemetry_File();
+    if (f == juce::File()) return;
+
+   #if JUCE_WINDOWS
+    //R2.00 The first instance makes the file. Growing it only ever adds zeros, so two instances doing it at once is fine.
+    if (f.getSize() < Size)
+    {
+        juce::FileOutputStream out(f);
+        if (!out.openedOk()) return;
+
+        char Zeros[4096] = {};
+        while (out.getPosition() < Size)
+            out.write(Zeros, size_t(juce::jmin(juce::int64(sizeof(Zeros)), Size - out.getPosition())));
+        out.flush();
+    }
+
+    Map = std::make_unique<juce::MemoryMappedFile>(f, juce::Range<juce::int64>(0, Size), juce::MemoryMappedFile::readWrite, false);
+    if ((Map->getData() == nullptr) || (Map->getSize() < size_t(Size)))
+    {
+        Map.reset();
+        return;
+    }
+
+    Segment = static_cast<tp_telemetry_segment*>(Map->getData());
+   #else
+    //R2.00 Never follow a link, and only use a plain file that is ours and only we can read and write.
+    //R2.00 ftruncate grows it with zeros, so two instances doing it at once is still fine. It is never shrunk.
+    int fd = open(f.getFullPathName().toRawUTF8(), O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0) return;
+
+    struct stat st = {};
+    bool Ok = (fstat(fd, &st) == 0) && S_ISREG(st.st_mode) && (st.st_uid == getuid()) && ((st.st_mode & 077) == 0);
+    if (Ok && (st.st_size < Size)) Ok = (ftruncate(fd, off_t(Size)) == 0);
+
+    void* p = Ok ? mmap(nullptr, size_t(Size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (p == MAP_FAILED) return;
+
+    Map_Data = p;
+    Segment = static_cast<tp_telemetry_segment*>(p);
+   #endif
+
+    //R2.00 Every instance writes the same header values, so there is nothing to race on.
+    Segment->Header.Version = Telemetry_Version;
+    Segment->Header.Slot_Count = uint32_t(Slot_Count);
+    Segment->Header.Slot_Size = uint32_t(sizeof(tp_telemetry_slot));
+    Segment->Header.Magic.store(Magic);
+
+    //R2.00 Take a free slot, or one left behind by a host that crashed.
+    Pid = Mako_Process_Id();
+    for (int i = 0; i < Slot_Count; i++)
+    {
+        tp_telemetry_slot& s = Segment->Slots[i];
+        uint32_t Old = s.Owner.load();
+        if ((Old != 0) && ((Old == Pid) || Mako_Process_Alive(Old))) continue;
+        if (!s.Owner.compare_exchange_strong(Old, Pid)) continue;
+
+        //R2.00 A crashed writer can leave Seq odd. Make it even again and clear the old stats.
+        uint32_t Seq = s.Seq.load();
+        if ((Seq & 1) != 0) s.Seq.store(Seq + 1);
+        tp_telemetry_data Empty = {};
+        Mako_Telemetry_Write(s, Empty);
+
+        Slot = &s;
+        Slot_Index = i;
+        break;
+    }
+}
+
+MakoTelemetryPublisher::~MakoTelemetryPublisher()
+{
+    if (Slot != nullptr) Slot->Owner.store(0);
+
+   #if !JUCE_WINDOWS
+    if (Map_Data != nullptr) munmap(Map_Data, sizeof(tp_telemetry_segment));
+   #endif
+}
+
+void MakoTelemetryPublisher::Publish(tp_telemetry_data& Data)
+{
+    if (Slot == nullptr) return;
+
+    Blocks++;
+    if (Block_Ns_Max < Data.Block_Ns) Block_Ns_Max = Data.Block_Ns;
+    if (1.0f < Data.Peak_Out) Clips++;
+
+    Data.Blocks = Blocks;
+    Data.Block_Ns_Max = Block_Ns_Max;
+    Data.Clips = Clips;
+    Mako_Telemetry_Write(*Slot, Data);
+}
+
+juce::File MakoTelemetryPublisher::Mako_Telemetry_File()
+{
+    //R2.00 A fixed folder so every host (and the reader) finds the same file. JUCE puts its temp folder
+    //R2.00 in a per app place on macOS, so it is only used on Windows (where it is per user already).
+    //R2.00 Linux and macOS use a per user folder (Segment_Folder). No safe folder = no file.
+   #if JUCE_WINDOWS
+    return juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile(Segment_Name);
+   #else
+    std::string Dir = Segment_Folder(true);
+    if (Dir.empty()) return {};
+    return juce::File(juce::String(Dir.c_str())).getChildFile(Segment_Name);
+   #endif
+}
+
+uint32_t MakoTelemetryPublisher::Mako_Process_Id()
+{
+   #if JUCE_WINDOWS
+    return uint32_t(GetCurrentProcessId());
+   #else
+    return uint32_t(getpid());
+   #endif
+}
+
+bool MakoTelemetryPublisher::Mako_Process_Alive(uint32_t Id)
+{
+   #if JUCE_WINDOWS
+    HANDLE h = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, DWORD(Id));
+    if (h == nullptr) return (GetLastError() == ERROR_ACCESS_DENIED);
+    DWORD Code = 0;
+    bool Alive = (GetExitCodeProcess(h, &Code) != 0) && (Code == STILL_ACTIVE);
+    CloseHandle(h);
+    return Alive;
+   #else
+    return (kill(pid_t(Id), 0) == 0) || (errno == EPERM);
+   #endif
+}
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    Mako_TelemetryPublisher.h
+    R2.00 Plugin side of the TELEMETRY. See Mako_Telemetry.h.
+
+    The file is opened and a slot is claimed in the constructor (message
+    thread). If that fails (no temp folder, sandboxed host, table full, or
+    the file is not safe to use) the publisher just does nothing. Publish() is called from the audio thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Mako_Telemetry.h"
+
+class MakoTelemetryPublisher
+{
+public:
+    MakoTelemetryPublisher();
+    ~MakoTelemetryPublisher();
+
+    //R2.00 Audio thread. Fills in Blocks, Block_Ns_Max and Clips, then copies the stats into our slot.
+    //R2.00 No locks, no system calls.
+    void Publish(MakoTelemetry::tp_telemetry_data& Data);
+
+    //R2.00 Slot index in the file, -1 if we are not publishing.
+    int getSlot() const { return Slot_Index; }
+
+private:
+    JUCE_DECLARE_NON_COPYABLE(MakoTelemetryPublisher)
+
+    std::unique_ptr<juce::MemoryMappedFile> Map;    //R2.00 Windows.
+    void* Map_Data = nullptr;                       //R2.00 Linux and macOS (mmap of our own checked file).
+    MakoTelemetry::tp_telemetry_segment* Segment = nullptr;
+    MakoTelemetry::tp_telemetry_slot* Slot = nullptr;
+    int Slot_Index = -1;
+    uint32_t Pid = 0;
+
+    //R2.00 Running values kept by the audio thread.
+    uint64_t Blocks = 0;
+    float Block_Ns_Max = 0.0f;
+    uint32_t Clips = 0;
+
+    static juce::File Mako_Telemetry_File();
+    static uint32_t Mako_Process_Id();
+    static bool Mako_Process_Alive(uint32_t Id);
+};
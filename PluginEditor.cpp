@@ -9,9 +9,43 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+//==============================================================================
+JUCE_IMPLEMENT_SINGLETON(MakoEditorAssets)
+
+MakoEditorAssets::MakoEditorAssets()
+{
+    //R1.00 Update the Look and Feel (Global colors) so drop down menu is the correct color. 
+    //R2.30 These are global, so they only need setting once, not every time an editor opens.
+    juce::LookAndFeel& LnF = juce::LookAndFeel::getDefaultLookAndFeel();
+    LnF.setColour(juce::DocumentWindow::backgroundColourId, juce::Colour(32, 32, 32));
+    LnF.setColour(juce::DocumentWindow::textColourId, juce::Colour(255, 255, 255));
+    LnF.setColour(juce::DialogWindow::backgroundColourId, juce::Colour(32, 32, 32));
+    LnF.setColour(juce::PopupMenu::backgroundColourId, juce::Colour(0, 0, 0));
+    LnF.setColour(juce::PopupMenu::highlightedBackgroundColourId, juce::Colour(192, 0, 0));
+    LnF.setColour(juce::TextButton::buttonOnColourId, juce::Colour(192, 0, 0));
+    LnF.setColour(juce::TextButton::buttonColourId, juce::Colour(0, 0, 0));
+    LnF.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0, 0, 0));
+    LnF.setColour(juce::ListBox::backgroundColourId, juce::Colour(32, 32, 32));
+    LnF.setColour(juce::Label::backgroundColourId, juce::Colour(32, 32, 32));
+}
+
+MakoEditorAssets::~MakoEditorAssets()
+{
+    clearSingletonInstance();
+}
+
+const juce::Image& MakoEditorAssets::getBackground()
+{
+    //R2.30 Decode straight from BinaryData. ImageCache would keep a second copy and drop it again after a few seconds.
+    if (imgBackground.isNull())
+        imgBackground = juce::ImageFileFormat::loadFrom(BinaryData::smacktalkback_png, size_t(BinaryData::smacktalkback_pngSize));
+
+    return imgBackground;
+}
+
 //==============================================================================
 MakoBiteAudioProcessorEditor::MakoBiteAudioProcessorEditor (MakoBiteAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p), Assets (*MakoEditorAssets::getInstance())
 {    
     //R1.00 Create SLIDER ATTACHMENTS so our parameter vars get adjusted automatically for Get/Set states.
     ParAtt[e_Gain] = std::make_unique <juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters, "gain", sldKnob[e_Gain]);
@@ -22,7 +56,7 @@ MakoBiteAudioProcessorEditor::MakoBiteAudioProcessorEditor (MakoBiteAudioProcess
     ParAtt[e_Mode] = std::make_unique <juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters, "mode", sldKnob[e_Mode]);
     ParAtt[e_Mono] = std::make_unique <juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters, "mono", sldKnob[e_Mono]);
         
-    imgBackground = juce::ImageCache::getFromMemory(BinaryData::smacktalkback_png, BinaryData::smacktalkback_pngSize);
+    //R2.30 The background image is not loaded here any more. paint() gets it from Assets the first time it draws.
 
     //****************************************************************************************
     //R1.00 Add GUI CONTROLS
@@ -33,21 +67,9 @@ MakoBiteAudioProcessorEditor::MakoBiteAudioProcessorEditor (MakoBiteAudioProcess
     GUI_Init_Large_Slider(&sldKnob[e_Q], audioProcessor.Setting[e_Q], 0.0f, 1.0f, .01f, "", 1, 0xFF000000);
     GUI_Init_Large_Slider(&sldKnob[e_Mix], audioProcessor.Setting[e_Mix], 0.0f, 1.0f, .01f, "", 2, 0xFF000000);
    
-    GUI_Init_Small_Slider(&sldKnob[e_Mode], audioProcessor.Setting[e_Mode], 0, 1, 1, "");
+    GUI_Init_Small_Slider(&sldKnob[e_Mode], audioProcessor.Setting[e_Mode], 0, 3, 1, "");
     GUI_Init_Small_Slider(&sldKnob[e_Mono], audioProcessor.Setting[e_Mono], 0, 1, 1, "");    
     
-        
-    //R1.00 Update the Look and Feel (Global colors) so drop down menu is the correct color. 
-    getLookAndFeel().setColour(juce::DocumentWindow::backgroundColourId, juce::Colour(32, 32, 32));
-    getLookAndFeel().setColour(juce::DocumentWindow::textColourId, juce::Colour(255, 255, 255));
-    getLookAndFeel().setColour(juce::DialogWindow::backgroundColourId, juce::Colour(32, 32, 32));
-    getLookAndFeel().setColour(juce::PopupMenu::backgroundColourId, juce::Colour(0, 0, 0));
-    getLookAndFeel().setColour(juce::PopupMenu::highlightedBackgroundColourId, juce::Colour(192, 0, 0));
-    getLookAndFeel().setColour(juce::TextButton::buttonOnColourId, juce::Colour(192, 0, 0));
-    getLookAndFeel().setColour(juce::TextButton::buttonColourId, juce::Colour(0, 0, 0));
-    getLookAndFeel().setColour(juce::ComboBox::backgroundColourId, juce::Colour(0, 0, 0));
-    getLookAndFeel().setColour(juce::ListBox::backgroundColourId, juce::Colour(32, 32, 32));
-    getLookAndFeel().setColour(juce::Label::backgroundColourId, juce::Colour(32, 32, 32));
 
     //R1.00 Define our control positions to make drawing easier.
     KNOB_DefinePosition(e_NGate,    10, 20, 60, 60, "Gate");
@@ -56,12 +78,12 @@ MakoBiteAudioProcessorEditor::MakoBiteAudioProcessorEditor (MakoBiteAudioProcess
     KNOB_DefinePosition(e_Q,       220, 55, 60, 60, "Q");
     KNOB_DefinePosition(e_Mix,     290, 20, 60, 60, "Mix");
 
-    KNOB_DefinePosition(e_Mode,   13, 96, 51, 22, "Smack/Talk");
+    KNOB_DefinePosition(e_Mode,   13, 96, 51, 22, "Smack/Talk/Vox/Track");
     KNOB_DefinePosition(e_Mono,  293, 96, 51, 22, "Stereo/Mono");
     
     Knob_Cnt = 7;
 
-    //R1.00 Enable/Disable Controls as needed.
+    //R1.00 Enable/Disable Controls as needed. Q is used by TALK, VOX and TRACK.
     if (audioProcessor.Setting[e_Mode])
         sldKnob[e_Q].setEnabled(true);
     else
@@ -76,6 +98,8 @@ MakoBiteAudioProcessorEditor::MakoBiteAudioProcessorEditor (MakoBiteAudioProcess
 
 MakoBiteAudioProcessorEditor::~MakoBiteAudioProcessorEditor()
 {
+    //R2.30 The shared LnF outlives us. Let go of it before our sliders are destroyed.
+    for (int t = 0; t < e_Knobs; t++) sldKnob[t].setLookAndFeel(nullptr);
 }
 
 //==============================================================================
@@ -88,7 +112,7 @@ void MakoBiteAudioProcessorEditor::paint (juce::Graphics& g)
     
     if (UseImage)
     {
-        g.drawImageAt(imgBackground, 0, 0);        
+        g.drawImageAt(Assets.getBackground(), 0, 0);
     }
     else
     {
@@ -141,7 +165,7 @@ void MakoBiteAudioProcessorEditor::resized()
 
 
 //R1.00 Setup the SLIDER control edit values, Text Suffix (if any), UI tick marks, and Indicator Color.
-void MakoBiteAudioProcessorEditor::GUI_Init_Large_Slider(juce::Slider* slider, float Val, float Vmin, float Vmax, float Vinterval, juce::String Suffix, int TickStyle, int ThumbColor)
+void MakoBiteAudioProcessorEditor::GUI_Init_Large_Slider(juce::Slider* slider, float Val, float Vmin, float Vmax, float Vinterval, const juce::String& Suffix, int TickStyle, int ThumbColor)
 {
     //R1.00 Setup the slider edit parameters.
     slider->setTextBoxStyle(juce::Slider::NoTextBox, false, 60, 20);
@@ -152,7 +176,7 @@ void MakoBiteAudioProcessorEditor::GUI_Init_Large_Slider(juce::Slider* slider, f
     addAndMakeVisible(slider);
 
     //R1.00 Override the default Juce drawing routines and use ours.
-    slider->setLookAndFeel(&myLookAndFeel);
+    slider->setLookAndFeel(&Assets.LookAndFeel);
 
     //R1.00 Setup the type and colors for the sliders.
     slider->setSliderStyle(juce::Slider::SliderStyle::Rotary);
@@ -167,7 +191,7 @@ void MakoBiteAudioProcessorEditor::GUI_Init_Large_Slider(juce::Slider* slider, f
     slider->setColour(juce::Slider::rotarySliderOutlineColourId, juce::Colour(TickStyle));
 }
 
-void MakoBiteAudioProcessorEditor::GUI_Init_Small_Slider(juce::Slider* slider, float Val, float Vmin, float Vmax, float Vinterval, juce::String Suffix)
+void MakoBiteAudioProcessorEditor::GUI_Init_Small_Slider(juce::Slider* slider, float Val, float Vmin, float Vmax, float Vinterval, const juce::String& Suffix)
 {
     //R1.00 Setup the slider edit parameters.
     slider->setTextBoxStyle(juce::Slider::NoTextBox, false, 60, 20);
@@ -188,7 +212,7 @@ void MakoBiteAudioProcessorEditor::GUI_Init_Small_Slider(juce::Slider* slider, f
     slider->setColour(juce::Slider::thumbColourId, juce::Colour(0xFFE0E0E0));
 }
 
-void MakoBiteAudioProcessorEditor::KNOB_DefinePosition(int idx,float x, float y, float sizex, float sizey, juce::String name)
+void MakoBiteAudioProcessorEditor::KNOB_DefinePosition(int idx,float x, float y, float sizex, float sizey, const char* name)
 {
     Knob_Pos[idx].x = x;
     Knob_Pos[idx].y = y;
@@ -263,3 +287,21 @@ void MakoBiteAudioProcessorEditor::sliderValueChanged(juce::Slider* slider)
     return;
 }
 
+void MakoBiteAudioProcessorEditor::mouseDoubleClick(const juce::MouseEvent& e)
+{
+    //R1.70 Shift + double click turns the CAB IR off.
+    if (e.mods.isShiftDown())
+    {
+        audioProcessor.Core.Cab.ClearIR();
+        return;
+    }
+
+    //R1.70 Pick an IR file. The file is read and prepared here, on the message thread, never in processBlock.
+    IR_Chooser = std::make_unique<juce::FileChooser>("Load Cab IR", audioProcessor.Core.Cab.getFile(), "*.wav;*.aif;*.aiff");
+    IR_Chooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+        [this](const juce::FileChooser& fc)
+        {
+            juce::File IRFile = fc.getResult();
+            if (IRFile.existsAsFile()) audioProcessor.Core.Cab.LoadIR(IRFile);
+        });
+}
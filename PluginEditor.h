@@ -172,8 +172,8 @@ public:
         //R1.00 The knob SIZE must be performed first. It is then ROTATED around its center. Then moved (TRANSLATED) to the screen knob position.
         ColGrad = juce::ColourGradient(juce::Colour(0xFFFFFFFF), 0.0f, y, juce::Colour(0xFFA0A0A0), 0.0f, y + height, false);
         g.setGradientFill(ColGrad);
-        juce::Path pK = pathKnob;        
-        g.fillPath(pK, juce::AffineTransform::scale(radius).followedBy(juce::AffineTransform::rotation(angle).translated(centreX, centreY)));
+        //R2.30 fillPath takes the path by reference, no need to copy it every paint.
+        g.fillPath(pathKnob, juce::AffineTransform::scale(radius).followedBy(juce::AffineTransform::rotation(angle).translated(centreX, centreY)));
 
         //R1.00 Draw finger adjust dent/indicator.
         sinA = std::sinf(angle);
@@ -213,6 +213,29 @@ public:
 };
 
 
+//*******************************************************************************************************************
+//R2.30 Things every editor shares. Made on the first editor open and kept until the plugin is unloaded,
+//R2.30 so opening many plugin windows at once does not decode the same image and set the same colours each time.
+//*******************************************************************************************************************
+class MakoEditorAssets : public juce::DeletedAtShutdown
+{
+public:
+    MakoEditorAssets();
+    ~MakoEditorAssets() override;
+
+    //R2.30 The background PNG is decoded on the first paint, not when the editor is built.
+    const juce::Image& getBackground();
+
+    //R2.30 One LnF for every knob in every editor. Our knob drawing has no per editor state.
+    MakoLookAndFeel LookAndFeel;
+
+    JUCE_DECLARE_SINGLETON_SINGLETHREADED_MINIMAL(MakoEditorAssets)
+
+private:
+    juce::Image imgBackground;
+};
+
+
 //*******************************************************************************************************************
 //R1.00 Add SLIDER listener. BUTTON or TIMER listeners also go here if needed. Must add ValueChanged overrides!
 //*******************************************************************************************************************
@@ -225,6 +248,9 @@ public:
     //R1.00 OUR override functions.
     void sliderValueChanged(juce::Slider* slider) override;
 
+    //R1.70 Double click the background to load a CAB IR. Shift + double click removes it.
+    void mouseDoubleClick(const juce::MouseEvent& e) override;
+
     //==============================================================================
     void paint (juce::Graphics&) override;
     void resized() override;
@@ -234,35 +260,36 @@ private:
     // access the processor object that created it.
     MakoBiteAudioProcessor& audioProcessor;
 
-    MakoLookAndFeel myLookAndFeel;
+    //R2.30 Shared LnF and background image.
+    MakoEditorAssets& Assets;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MakoBiteAudioProcessorEditor)
 
-    juce::Image imgBackground;
+    //R1.70 Kept alive while the IR file window is open.
+    std::unique_ptr<juce::FileChooser> IR_Chooser;
 
     void Setting_UpdateProcessor(int SettingType);
 
-    void GUI_Init_Large_Slider(juce::Slider* slider, float Val, float Vmin, float Vmax, float Vinterval, juce::String Suffix, int TickStyle, int ThumbColor);
-    void GUI_Init_Small_Slider(juce::Slider* slider, float Val, float Vmin, float Vmax, float Vinterval, juce::String Suffix);
+    void GUI_Init_Large_Slider(juce::Slider* slider, float Val, float Vmin, float Vmax, float Vinterval, const juce::String& Suffix, int TickStyle, int ThumbColor);
+    void GUI_Init_Small_Slider(juce::Slider* slider, float Val, float Vmin, float Vmax, float Vinterval, const juce::String& Suffix);
     
+    //R1.00 These are the indexes into our Settings vars.
+    //R2.30 e_Knobs is how many controls we have. Everything below is sized to it.
+    enum { e_Gain, e_NGate, e_Sense, e_Q, e_Mix, e_Mode, e_Mono, e_Knobs };
+
     //R1.00 Define our UI Juce Slider controls.
     int Knob_Cnt = 0;
-    juce::Slider sldKnob[20];
-    juce::Slider jsP1_Mono;
+    juce::Slider sldKnob[e_Knobs];
 
     //R1.00 Define the coords and text for our knobs. Not JUCE related. 
-    t_KnobCoors Knob_Pos[30] = {};
-    juce::String Knob_Name[30] = {};
-    void KNOB_DefinePosition(int t, float x, float y, float sizex, float sizey, juce::String name);
-
-    //R1.00 These are the indexes into our Settings vars.
-    enum { e_Gain, e_NGate, e_Sense, e_Q, e_Mix, e_Mode, e_Mono,  };
+    t_KnobCoors Knob_Pos[e_Knobs] = {};
+    const char* Knob_Name[e_Knobs] = {};
+    void KNOB_DefinePosition(int t, float x, float y, float sizex, float sizey, const char* name);
 
 public:
     
     //R1.00 Define our SLIDER attachment variables.
-    std::unique_ptr <juce::AudioProcessorValueTreeState::SliderAttachment> ParAtt[20];
-    std::unique_ptr <juce::AudioProcessorValueTreeState::SliderAttachment> ParAtt_Mono;
+    std::unique_ptr <juce::AudioProcessorValueTreeState::SliderAttachment> ParAtt[e_Knobs];
 
   
 
@@ -17,6 +17,7 @@ MakoBiteAudioProcessor::MakoBiteAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)     //R2.40 Key for the envelope.
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
@@ -31,13 +32,30 @@ MakoBiteAudioProcessor::MakoBiteAudioProcessor()
         std::make_unique<juce::AudioParameterFloat>("sense","Sense", .0f, 1.0f, .3f),
         std::make_unique<juce::AudioParameterFloat>("q","Q", .0f, 1.0f, .5f),
         std::make_unique<juce::AudioParameterFloat>("mix","Mix", .0f, 1.0f, 1.0f),
-        std::make_unique<juce::AudioParameterInt>("mode","Mode", 0, 1, 1),
+        std::make_unique<juce::AudioParameterInt>("mode","Mode", 0, 3, 1),
         std::make_unique<juce::AudioParameterInt>("mono","Mono", 0, 1, 1),        
+        std::make_unique<juce::AudioParameterInt>("ctrlrate","Control Rate", 1, 64, 16),
+        std::make_unique<juce::AudioParameterChoice>("quality","Quality", juce::StringArray { "Eco", "Standard", "High" }, 1),
+        std::make_unique<juce::AudioParameterBool>("offlinehigh","Offline High Quality", true),
+        std::make_unique<juce::AudioParameterFloat>("ratio","Track Ratio", .5f, 8.0f, 2.0f),
+        std::make_unique<juce::AudioParameterFloat>("track","Track Amount", .0f, 1.0f, .75f),
+        std::make_unique<juce::AudioParameterChoice>("detect","Envelope Detect", juce::StringArray { "Per Channel", "Link Max", "Link Average", "Sidechain" }, 0),
+        std::make_unique<juce::AudioParameterBool>("softclip","Output Soft Clip", false),
+        std::make_unique<juce::AudioParameterFloat>("ceiling","Output Ceiling", -24.0f, 0.0f, -.3f),
       }
     )   
 
 #endif
 {   
+    //R1.30 Host only parameters. Keep a pointer so processBlock never has to look them up by name.
+    Parm_CtrlRate = parameters.getRawParameterValue("ctrlrate");
+    Parm_Quality = parameters.getRawParameterValue("quality");
+    Parm_OfflineHigh = parameters.getRawParameterValue("offlinehigh");
+    Parm_Ratio = parameters.getRawParameterValue("ratio");
+    Parm_Track = parameters.getRawParameterValue("track");
+    Parm_Detect = parameters.getRawParameterValue("detect");
+    Parm_SoftClip = parameters.getRawParameterValue("softclip");
+    Parm_Ceiling = parameters.getRawParameterValue("ceiling");
 }
 
 MakoBiteAudioProcessor::~MakoBiteAudioProcessor()
@@ -112,13 +130,15 @@ void MakoBiteAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
 
-    //R1.00 Get our Sample Rate for filter calculations.
-    SampleRate = MakoBiteAudioProcessor::getSampleRate();
-    if (SampleRate < 21000) SampleRate = 48000;
-    if (192000 < SampleRate) SampleRate = 48000;
-
-    //R1.00 Calculate and pre-Run variables/filters/etc.
+    //R1.60 All our DSP lives in the core. Copy our settings in before it builds its tables.
     Mako_Settings_Update(true);
+
+    double rate = sampleRate;
+    if (rate <= 0.0) rate = 48000;
+    Core.prepare({ rate, juce::uint32(juce::jmax(1, samplesPerBlock)), juce::uint32(juce::jmax(1, getTotalNumOutputChannels())) });
+
+    //R1.40 Our latency is the HIGH tiers latency, whatever tier is used.
+    setLatencySamples(Core.getLatencySamples());
 }
 
 void MakoBiteAudioProcessor::releaseResources()
@@ -146,6 +166,14 @@ bool MakoBiteAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    //R2.40 SIDECHAIN can be off, mono or stereo.
+    if (1 < layouts.inputBuses.size())
+    {
+        auto Key = layouts.getChannelSet(true, 1);
+        if (!Key.isDisabled() && (Key != juce::AudioChannelSet::mono()) && (Key != juce::AudioChannelSet::stereo()))
+            return false;
+    }
    #endif
 
     return true;
@@ -154,18 +182,48 @@ bool MakoBiteAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 #endif
 
 void MakoBiteAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    Mako_Process(buffer, false);
+}
+
+//R2.90 BYPASS. The host's bypass. We keep our latency (the input comes out delayed by it) and keep the envelope
+//R2.90 running, so nothing jumps when bypass goes off. Going in and out is crossfaded over 10ms.
+void MakoBiteAudioProcessor::processBlockBypassed (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    Mako_Process(buffer, true);
+}
+
+void MakoBiteAudioProcessor::Mako_Process(juce::AudioBuffer<float>& buffer, bool Bypassed)
 {
     juce::ScopedNoDenormals noDenormals;
+
+    //R1.90 Debug builds with MAKO_RT_CHECK=1 report any allocation, lock or blocking call from here on.
+    [[maybe_unused]] MakoRTScope RTCheck;
+
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-    //R1.00 Our defined variables.
-    float tS;  //R1.00 Temporary Sample.
+    //R2.40 The SIDECHAIN channels come after the main input channels in the same buffer.
+    auto mainNumInputChannels = getMainBusNumInputChannels();
 
     //R1.00 Handle any changes to our Paramters.
     //R1.00 Handle any settings changes made in Editor. 
     if (0 < SettingsChanged) Mako_Settings_Update(false);
 
+    //R1.40 Pick our quality tier. Offline renders can be promoted to HIGH.
+    //R1.60 The core reads these at the start of every block.
+    Core.Quality = int(Parm_Quality->load());
+    Core.ForceHigh = isNonRealtime() && (.5f < Parm_OfflineHigh->load());
+    Core.CtrlRate = int(Parm_CtrlRate->load());
+    Core.Setting[MakoSmackTalkCore::e_Ratio] = Parm_Ratio->load();
+    Core.Setting[MakoSmackTalkCore::e_Track] = Parm_Track->load();
+    Core.Setting[MakoSmackTalkCore::e_Detect] = Parm_Detect->load();
+    Core.OutClip = (.5f < Parm_SoftClip->load());
+    Core.OutCeiling_dB = Parm_Ceiling->load();
+    Core.Bypass = Bypassed;
+
     // In case we have more outputs than inputs, this code clears any output
     // channels that didn't contain input data, (because these aren't
     // guaranteed to be empty - they may contain garbage).
@@ -175,47 +233,40 @@ void MakoBiteAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    // This is the place where you'd normally do the guts of your plugin's
-    // audio processing...
-    // Make sure to reset the state if your inner loop is processing
-    // the samples and the outer loop is handling the channels.
-    // Alternatively, you can process the samples with the channels
-    // interleaved by keeping the same state.
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-    {
-        auto* channelData = buffer.getWritePointer (channel);
-
-        //R1.00 Process the AUDIO buffer data.
-        if (Setting[e_Mono] && (channel == 1))
-        {
-            auto* channel0Data = buffer.getWritePointer(0);
-
-            //R1.00 FORCE MONO - Put CHANNEL 0 data in CHANNEL 1.
-            for (int samp = 0; samp < buffer.getNumSamples(); samp++) channelData[samp] = channel0Data[samp];
-        }
-        else
-        {
-            // ..do something to the data...
-            for (int samp = 0; samp < buffer.getNumSamples(); samp++)
-            {
-                //R1.00 Get the current sample and put it in tS. 
-                tS = buffer.getSample(channel, samp);
-
-                //R1.00 Noise gate. Always call because Signal_AVG is calculated in here.
-                tS = Mako_FX_NoiseGate(tS, channel);
-                
-                //R1.00 Apply one of our world famous effects.
-                switch (int(Setting[e_Mode]))
-                {
-                case 1: tS = Mako_FX_AutoWah(tS, channel); break;
-                default: tS = Mako_FX_SynthDrive(tS, channel); break;
-                }
-
-                //R1.00 Write our modified sample back into the sample buffer.
-                channelData[samp] = tS;
-            }
-        }
-    }
+    //R2.40 Point the core at the SIDECHAIN channels where they are. No copies.
+    float* const* Key = nullptr;
+    int KeyChannels = totalNumInputChannels - mainNumInputChannels;
+    if (0 < KeyChannels) Key = buffer.getArrayOfWritePointers() + mainNumInputChannels;
+
+    //R1.60 Process the AUDIO buffer data in place.
+    Core.process(buffer.getArrayOfWritePointers(), mainNumInputChannels, buffer.getNumSamples(), Key, KeyChannels);
+
+    //R2.00 Let Tools/MakoTop see how we are doing.
+    Mako_Telemetry_Publish(buffer.getNumSamples());
+}
+
+//R2.00 TELEMETRY. Gather the stats of this block. Everything here is a plain read, it costs next to nothing.
+void MakoBiteAudioProcessor::Mako_Telemetry_Publish(int numSamples)
+{
+    //R2.00 In mono only channel 0 runs the envelope and gate.
+    int ch1 = ((.5f < Core.Setting[MakoSmackTalkCore::e_Mono]) || (getMainBusNumInputChannels() < 2)) ? 0 : 1;
+
+    MakoTelemetry::tp_telemetry_data Stats = {};
+    Stats.Mode = int(Core.Setting[MakoSmackTalkCore::e_Mode]);
+    Stats.Tier = Core.ForceHigh ? int(MakoSmackTalkCore::e_TierHigh) : Core.Quality;
+    Stats.BlockSize = numSamples;
+    Stats.SampleRate = float(getSampleRate());
+    Stats.Block_Ns = Core.Block_Ns;
+    Stats.Envelope = juce::jmax(Core.Signal_AVG[0], Core.Signal_AVG[ch1]);
+    Stats.Peak_Out = Core.Peak_Out;
+
+    //R2.00 The gate factor is only kept up to date while the gate is on.
+    if (Core.Setting[MakoSmackTalkCore::e_NGate] < .0001f)
+        Stats.Gate = -1.0f;
+    else
+        Stats.Gate = juce::jmin(Core.Pedal_NGate_Fac[0], Core.Pedal_NGate_Fac[ch1]);
+
+    Telemetry.Publish(Stats);
 }
 
 //==============================================================================
@@ -239,6 +290,9 @@ void MakoBiteAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
     
     //R1.00 Save our parameters to file/DAW.
     auto state = parameters.copyState();
+
+    //R1.70 Remember the CAB IR file. The IR itself is not saved, it is read from the file again.
+    state.setProperty("irfile", Core.Cab.getFile().getFullPathName(), nullptr);
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
     copyXmlToBinary(*xml, destData);
    
@@ -264,6 +318,16 @@ void MakoBiteAudioProcessor::setStateInformation (const void* data, int sizeInBy
     Setting[e_Mix] = Mako_GetParmValue_float("mix");
     Setting[e_Mode] = Mako_GetParmValue_float("mode");
     Setting[e_Mono] = Mako_GetParmValue_float("mono");    
+
+    //R1.10 Let the processor recalc anything that depends on our settings (VOX table).
+    SettingsChanged += 1;
+
+    //R1.70 Load the CAB IR this preset used. If the file has moved the IR is left off.
+    juce::String IRFile = parameters.state.getProperty("irfile").toString();
+    if (IRFile.isNotEmpty() && juce::File(IRFile).existsAsFile())
+        Core.Cab.LoadIR(juce::File(IRFile));
+    else
+        Core.Cab.ClearIR();
 }
 
 //R1.00 Parameter reading helper function.
@@ -286,25 +350,6 @@ float MakoBiteAudioProcessor::Mako_GetParmValue_float(juce::String Pstring)
         return 0.0f;
 }
 
-//R1.00 Volume envelope based on average Signal volume.
-float MakoBiteAudioProcessor::Mako_FX_NoiseGate(float tSample, int channel)
-{
-    //R1.00 Track our Input Signal Average (Absolute vals). We need this for gate and WAH so always calc.
-    //R1.00 NEEDS: This needs to be adjusted for sample rate, but it is not!!! 
-    Signal_AVG[channel] = (Signal_AVG[channel] * .995) + (abs(tSample) * .005);
-
-    //R1.00 If not using the Gate, exit out and save a few CPU cycles.
-    if (Setting[e_NGate] < .0001f) return tSample;
-
-    //R1.00 Create a volume envelope based on Signal Average.
-    Pedal_NGate_Fac[channel] = Signal_AVG[channel] * 10000.0f * (1.1f - Setting[e_NGate]);
-
-    //R1.00 Dont amplify the sound, just reduce when necessary.
-    if (1.0f < Pedal_NGate_Fac[channel]) Pedal_NGate_Fac[channel] = 1.0f;
-
-    return tSample * Pedal_NGate_Fac[channel];
-}
-
 
 //==============================================================================
 // This creates new instances of the plugin..
@@ -313,118 +358,14 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
     return new MakoBiteAudioProcessor();
 }
 
-//R1.00 Apply filter to a sample.
-float MakoBiteAudioProcessor::Filter_Calc_BiQuad(float tSample, int channel, tp_filter* fn)
-{
-    float tS = tSample;
-
-    fn->xn0[channel] = tS;
-    tS = fn->a0 * fn->xn0[channel] + fn->a1 * fn->xn1[channel] + fn->a2 * fn->xn2[channel] - fn->b1 * fn->yn1[channel] - fn->b2 * fn->yn2[channel];
-    fn->xn2[channel] = fn->xn1[channel]; fn->xn1[channel] = fn->xn0[channel]; fn->yn2[channel] = fn->yn1[channel]; fn->yn1[channel] = tS;
-
-    return tS;
-}
-
-//R1.00 Second order parametric/peaking boost filter with constant-Q
-void MakoBiteAudioProcessor::Filter_BP_Coeffs(float Gain_dB, float Fc, float Q, tp_filter* fn)
-{    
-    float K = pi2 * (Fc * .5f) / SampleRate;
-    float K2 = K * K;
-    float V0 = pow(10.0, Gain_dB / 20.0);
-
-    float a = 1.0f + (V0 * K) / Q + K2;
-    float b = 2.0f * (K2 - 1.0f);
-    float g = 1.0f - (V0 * K) / Q + K2;
-    float d = 1.0f - K / Q + K2;
-    float dd = 1.0f / (1.0f + K / Q + K2);
-
-    fn->a0 = a * dd;
-    fn->a1 = b * dd;
-    fn->a2 = g * dd;
-    fn->b1 = b * dd;
-    fn->b2 = d * dd;
-    fn->c0 = 1.0f;
-    fn->d0 = 0.0f;
-}
-
-//R1.00 Second order LOW PASS filter. 
-void MakoBiteAudioProcessor::Filter_LP_Coeffs(float fc, tp_filter* fn)
-{    
-    float c = 1.0f / (tanf(pi * fc / SampleRate));
-    fn->a0 = 1.0f / (1.0f + sqrt2 * c + (c * c));
-    fn->a1 = 2.0f * fn->a0;
-    fn->a2 = fn->a0;
-    fn->b1 = 2.0f * fn->a0 * (1.0f - (c * c));
-    fn->b2 = fn->a0 * (1.0f - sqrt2 * c + (c * c));
-}
-
-//F1.00 Second order butterworth High Pass.
-void MakoBiteAudioProcessor::Filter_HP_Coeffs(float fc, tp_filter* fn)
-{    
-    float c = tanf(pi * fc / SampleRate);
-    fn->a0 = 1.0f / (1.0f + sqrt2 * c + (c * c));
-    fn->a1 = -2.0f * fn->a0;
-    fn->a2 = fn->a0;
-    fn->b1 = 2.0f * fn->a0 * ((c * c) - 1.0f);
-    fn->b2 = fn->a0 * (1.0f - sqrt2 * c + (c * c));
-}
-
-//R1.00 Create an Envelope Filter based on Signal_AVG value.
-float MakoBiteAudioProcessor::Mako_FX_AutoWah(float tSample, int channel)
-{
-    //R1.00 Exit if not even using Modulate.
-    if (Setting[e_Mix] < .001f) return tSample;
-
-    float tS;
-
-    //R2.00 Envelope Filter.
-    float tFac = Signal_AVG[channel] * 500.0f * (Setting[e_Sense] * Setting[e_Sense]);
-    if (.90f < tFac) tFac = .90f;
-    if (tFac < .0001f) tFac = .0001f;
-
-    //R1.00 Adjust the WAH filter. 
-    //R1.00 This is an expensive calculation. We are reducing the number of calcs based on signal change.
-    //R1.00 The smaller the number the more often it is calc. Not calc enough and it sounds robotic due to the larger steps.
-    if (.025 < abs(tFac / Factor_Last))
-    {
-        Factor_Last = tFac;
-        Filter_BP_Coeffs((Setting[e_Q] * 30.0f), 800.0f * (.1f + tFac), 1.4f * (.1f + tFac * 3.0f), &makoF_AutoWah);
-    }
-
-    //R1.00 apply our WAH effect filter.
-    tS = Filter_Calc_BiQuad(tSample, channel, &makoF_AutoWah);
-    
-    //Volume/Gain adjust. Reduction only.
-    tS *= Setting[e_Gain];
-
-    return (tSample * (1.0f - Setting[e_Mix])) + (tS * Setting[e_Mix]);
-}
-
-float MakoBiteAudioProcessor::Mako_FX_SynthDrive(float tSample, int channel)
-{
-    //R1.00 Exit if not even using SynthDrive.
-    if (Setting[e_Mix] < .001f) return tSample;
-
-    //R1.00 Apply our Synth effect filter.
-    //R1.00 TFac pushes the frequency of our signal up. We also use it to balance out the gain in volume.
-    float tFac = (1.0f + (Setting[e_Sense] * 50));
-    float tS = sinf(tSample * tFac) * (1.5f / tFac);
-
-    //R1.00 Volume/Gain adjust.
-    tS *= Setting[e_Gain];
-
-    return (tSample * (1.0f - Setting[e_Mix])) + (tS * Setting[e_Mix]);
-}
-
-
 void MakoBiteAudioProcessor::Mako_Settings_Update(bool ForceAll)
 {
     //R1.00 We do changes here so we know the vars are not in use while we change them.
     //R1.00 EDITOR sets SETTING flags and we make changes here.
-    bool Force = ForceAll;
+    //R1.60 The core does the real work. It checks what changed on its next block.
+    juce::ignoreUnused(ForceAll);
+    for (int i = 0; i <= e_Mono; i++) Core.Setting[i] = Setting[i];
 
-    //R1.00 This VST has no settings adjusted variables yet.
-    
     //R1.00 RESET out settings flags.
     SettingsType = 0;
     SettingsChanged = false;
@@ -9,6 +9,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "Mako_Core.h"
+#include "Mako_TelemetryPublisher.h"
 
 //==============================================================================
 /**
@@ -32,6 +34,7 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -64,15 +67,18 @@ public:
     int SettingsChanged = 0;
     int SettingsType = 0;
     float Setting[10] = {};
-    float Setting_Last[10] = {};
 
-    //R1.00 Our public variables.
-    float Pedal_NGate_Fac[2] = {};    //R1.00 Noise Gate.
-    float Signal_AVG[2] = {};       
+    //R1.60 All of our DSP. The processor only handles parameters and the host.
+    //R1.60 Set Core.Kernel_Override (e_Isa...) before prepareToPlay to force a kernel set for A/B testing.
+    //R1.60 Core.Tier_NsPerSample has the measured cost of each quality tier.
+    MakoSmackTalkCore Core;
 
     //R1.00 These are the indexes into our Settings var.
     enum { e_Gain, e_NGate, e_Sense, e_Q, e_Mix, e_Mode, e_Mono, };
 
+    //R1.10 The values our e_Mode setting can be.
+    enum { e_ModeSmack, e_ModeTalk, e_ModeVox, e_ModeTrack, };
+
 
 private:
     //==============================================================================
@@ -85,53 +91,26 @@ private:
     //R1.00 Handle parameter changes made in editor.
     void Mako_Settings_Update(bool ForceAll);
 
-    //R1.00 Our actual AUDIO adjusting functions.
-    float Mako_FX_NoiseGate(float tSample, int channel);
-    float Mako_FX_AutoWah(float tSample, int channel);
-    float Mako_FX_SynthDrive(float tSample, int channel);
-    
-    //R1.00 Some Constants and vars.
-    const float pi = 3.14159265f;
-    const float pi2 = 6.2831853f;
-    const float sqrt2 = 1.4142135f;
-    float SampleRate = 48000.0f;
-
-    //R1.00 OUR FILTER VARIABLES
-    struct tp_coeffs {
-        float a0;
-        float a1;
-        float a2;
-        float b1;
-        float b2;
-        float c0;
-        float d0;
-    };
-
-    struct tp_filter {
-        float a0;
-        float a1;
-        float a2;
-        float b1;
-        float b2;
-        float c0;
-        float d0;
-        float xn0[2];
-        float xn1[2];
-        float xn2[2];
-        float yn1[2];
-        float yn2[2];
-        float offset[2];
-    };
-
-    //R1.00 FILTER FUNCTIONS
-    float Filter_Calc_BiQuad(float tSample, int channel, tp_filter* fn);
-    void Filter_BP_Coeffs(float Gain_dB, float Fc, float Q, tp_filter* fn);
-    void Filter_LP_Coeffs(float fc, tp_filter* fn);
-    void Filter_HP_Coeffs(float fc, tp_filter* fn);    
-
-    //R1.00 Our pedal filters and function def.
-    tp_filter makoF_AutoWah = {};
-    float Factor_Last = 1.0f;       //R1.00 The last filter calc factor. Track to reduce calculations.
-    
+    //R2.90 processBlock and processBlockBypassed both end up here. The core does the BYPASS and its fades.
+    void Mako_Process(juce::AudioBuffer<float>& buffer, bool Bypassed);
+
+    //R1.30 Host only parameters. Passed to the core every block.
+    std::atomic<float>* Parm_CtrlRate = nullptr;
+    std::atomic<float>* Parm_Quality = nullptr;
+    std::atomic<float>* Parm_OfflineHigh = nullptr;
+
+    //R1.80 TRACK mode. Filter center = pitch x Ratio, blended with the envelope by Track.
+    std::atomic<float>* Parm_Ratio = nullptr;
+    std::atomic<float>* Parm_Track = nullptr;
+
+    //R2.40 ENVELOPE DETECTION. Per channel, stereo linked, or keyed by the SIDECHAIN bus.
+    std::atomic<float>* Parm_Detect = nullptr;
+
+    //R2.80 OUTPUT SAFETY soft clipper and its ceiling (dBFS).
+    std::atomic<float>* Parm_SoftClip = nullptr;
+    std::atomic<float>* Parm_Ceiling = nullptr;
 
+    //R2.00 TELEMETRY. Our stats go to a shared memory slot at the end of every block (Tools/MakoTop shows them).
+    MakoTelemetryPublisher Telemetry;
+    void Mako_Telemetry_Publish(int numSamples);
 };
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    MakoBench.cpp
+    R1.40 Runs the TIER BENCHMARK (Mako_Bench.h) and prints what each
+    quality tier costs in every mode. Copy the table into the README
+    QUALITY section when the DSP changes.
+    R1.80 Also runs the PITCH BENCHMARK at a few block sizes. Copy that
+    table into the README TRACK EFFECT section.
+
+    Build it as a Projucer Console Application: add this file and every
+    plugin .cpp file, the same JUCE modules as the plugin, and add
+    JucePlugin_Name="MakoSmackTalk" to the preprocessor definitions.
+    Build it in Release, a Debug build measures the debug checks.
+
+    MakoBench [-rate hz] [-block n] [-seconds s] [-runs n] [-only tiers|pitch]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Mako_Bench.h"
+#include <cstdio>
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI Init;
+
+    tp_bench_config Config;
+    juce::String Only;
+    for (int a = 1; (a + 1) < argc; a += 2)
+    {
+        juce::String Arg = argv[a], Val = argv[a + 1];
+        if (Arg == "-rate") Config.SampleRate = Val.getDoubleValue();
+        else if (Arg == "-block") Config.BlockSize = Val.getIntValue();
+        else if (Arg == "-seconds") Config.Seconds = Val.getDoubleValue();
+        else if (Arg == "-runs") Config.Runs = Val.getIntValue();
+        else if (Arg == "-only") Only = Val;
+    }
+
+    if (Only != "pitch")
+    {
+        const char* const Mode_Names[tp_bench_result::Mode_Count] = { "Smack", "Talk", "Vox", "Track" };
+
+        tp_bench_result Result;
+        Mako_Bench_Tiers(Config, Result);
+
+        std::printf("Tier cost, ns per stereo sample (%s kernels, %.0f Hz, %d sample blocks)\n", Result.Kernels.toRawUTF8(), Config.SampleRate, Config.BlockSize);
+        std::printf("%-8s %9s %9s %9s\n", "Mode", "Eco", "Standard", "High");
+        for (int m = 0; m < tp_bench_result::Mode_Count; m++)
+            std::printf("%-8s %9.1f %9.1f %9.1f\n", Mode_Names[m], Result.Tier_NsPerSample[m][0], Result.Tier_NsPerSample[m][1], Result.Tier_NsPerSample[m][2]);
+        std::printf("\n");
+    }
+
+    if (Only != "tiers")
+    {
+        //R1.80 Small blocks show the worst block best, big ones the average.
+        const int Blocks[] = { 32, 128, 512, 2048 };
+
+        std::printf("Pitch detector, one channel (%.0f Hz, %.0f Hz note)\n", Config.SampleRate, double(tp_pitch_bench_config().Note_Hz));
+        std::printf("%-6s %10s %12s %12s %12s %9s\n", "Block", "ns/sample", "median ns", "99.9% ns", "worst ns", "found Hz");
+        for (int b : Blocks)
+        {
+            tp_pitch_bench_config PitchConfig;
+            PitchConfig.SampleRate = Config.SampleRate;
+            PitchConfig.BlockSize = b;
+
+            tp_pitch_bench_result Result;
+            Mako_Bench_Pitch(PitchConfig, Result);
+            std::printf("%-6d %10.1f %12.0f %12.0f %12.0f %9.2f\n", b, Result.Avg_NsPerSample, Result.Median_BlockNs, Result.P999_BlockNs, Result.Max_BlockNs, double(Result.Pitch_Hz));
+        }
+    }
+
+    return 0;
+}
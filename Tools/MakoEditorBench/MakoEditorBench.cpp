@@ -0,0 +1,44 @@
+/*
+  ==============================================================================
+
+    MakoEditorBench.cpp
+    R2.30 Runs the EDITOR OPEN BENCHMARK (Mako_EditorBench.h) and returns 1 if
+    a later open took longer than the budget.
+
+    Build it as a Projucer Console Application: add this file and every
+    plugin .cpp file, the same JUCE modules as the plugin (juce_gui_basics is
+    needed here), BinaryData, and add JucePlugin_Name="MakoSmackTalk" to the
+    preprocessor definitions.
+
+    MakoEditorBench [-opens n] [-budget ms]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Mako_EditorBench.h"
+#include <cstdio>
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI Init;
+
+    tp_editor_bench_config Config;
+    for (int a = 1; (a + 1) < argc; a += 2)
+    {
+        juce::String Arg = argv[a], Val = argv[a + 1];
+        if (Arg == "-opens") Config.Opens = Val.getIntValue();
+        else if (Arg == "-budget") Config.Budget_Ms = Val.getDoubleValue();
+    }
+
+    MakoBiteAudioProcessor Proc;
+    tp_editor_bench_result Result;
+    bool Passed = Mako_EditorBench_Run(Proc, Config, Result);
+
+    std::printf("First open: construct %.3f ms, first paint %.3f ms\n", Result.First_Construct_Ms, Result.First_Paint_Ms);
+    std::printf("Later opens: construct %.3f ms, first paint %.3f ms, total %.3f ms, worst %.3f ms\n",
+                Result.Avg_Construct_Ms, Result.Avg_Paint_Ms, Result.Avg_Ms, Result.Max_Ms);
+    std::printf("%s\n", Passed ? "PASSED" : "FAILED");
+
+    return Passed ? 0 : 1;
+}
@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    MakoGolden.cpp
+    R2.20 Runs the GOLDEN RENDER SUITE (Mako_Golden.h) and returns 1 if any
+    path is out of tolerance, so it can gate a release.
+
+    Build it as a Projucer Console Application: add this file and every
+    plugin .cpp file, the same JUCE modules as the plugin, and add
+    JucePlugin_Name="MakoSmackTalk" to the preprocessor definitions.
+
+    MakoGolden [-rate hz] [-block n] [file.wav ...]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Mako_Golden.h"
+#include <cstdio>
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI Init;
+
+    tp_golden_config Config;
+    for (int a = 1; a < argc; a++)
+    {
+        juce::String Arg = argv[a];
+        if ((Arg == "-rate") && ((a + 1) < argc)) Config.SampleRate = juce::String(argv[++a]).getDoubleValue();
+        else if ((Arg == "-block") && ((a + 1) < argc)) Config.BlockSize = juce::String(argv[++a]).getIntValue();
+        else Config.Files.add(juce::File::getCurrentWorkingDirectory().getChildFile(Arg));
+    }
+
+    tp_golden_result Result;
+    bool Passed = Mako_Golden_Run(Config, Result);
+
+    std::printf("%-24s %10s %9s %9s %8s\n", "Path", "Max abs", "Null dB", "Spec dB", "Speed");
+    for (const auto& p : Result.Paths)
+    {
+        std::printf("%-24s %10.6f %9.1f %9.3f %7.2fx  %s%s\n", p.Name.toRawUTF8(), p.MaxAbs, p.Null_dB, p.Spectral_dB, p.Speedup,
+                    p.Passed ? "PASS" : "FAIL", p.Spectrum_Only ? " (spectrum only)" : "");
+        if (!p.Passed) std::printf("    worst item: %s\n", p.Worst_Item.toRawUTF8());
+    }
+    std::printf("%s\n", Passed ? "PASSED" : "FAILED");
+
+    return Passed ? 0 : 1;
+}
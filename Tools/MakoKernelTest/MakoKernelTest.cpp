@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    MakoKernelTest.cpp
+    R1.20 Checks the CPU KERNELS on the build box and returns 1 if anything
+    is wrong, so it can gate a release:
+      - every kernel set that is built and that this CPU can run gives the
+        same results as the Scalar set (Mako_Kernels_SelfTest)
+      - the fallback chain picks the right set for CPUs we do not have
+        (the CPU check is faked with Mako_Kernels_Pick)
+      - MAKO_SMACKTALK_ISA names are read right, and unknown or unsupported
+        values fall back to the best set this CPU can run
+
+    Build it as a Projucer Console Application: add this file and the
+    Mako_Kernels*.cpp files. Only the juce_core module is needed.
+
+    MakoKernelTest
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Mako_Kernels.h"
+#include <cstdio>
+
+namespace
+{
+    const char* const Isa_Names[e_IsaCount] = { "Auto", "Scalar", "SSE2", "AVX2", "AVX512" };
+
+    int Fails = 0;
+
+    void Mako_Check(bool Ok, const char* What)
+    {
+        std::printf("%-56s %s\n", What, Ok ? "ok" : "FAIL");
+        if (!Ok) Fails++;
+    }
+
+    //R1.20 A fake CPU: one bit per set it can run. Scalar is always there.
+    unsigned Mako_Cpu(bool SSE2, bool AVX2, bool AVX512)
+    {
+        return (1u << e_IsaScalar) | (SSE2 ? (1u << e_IsaSSE2) : 0u) | (AVX2 ? (1u << e_IsaAVX2) : 0u) | (AVX512 ? (1u << e_IsaAVX512) : 0u);
+    }
+}
+
+int main()
+{
+    //R1.20 1. Every set this CPU can run must match the Scalar set.
+    unsigned Available = Mako_Kernels_Available();
+    std::printf("Self test\n");
+    for (int Isa = e_IsaScalar; Isa < e_IsaCount; Isa++)
+    {
+        const tp_kernels* k = Mako_Kernels_Table(Isa);
+        if (k == nullptr) { std::printf("%-56s not built\n", Isa_Names[Isa]); continue; }
+        if ((Available & (1u << Isa)) == 0) { std::printf("%-56s CPU can not run it\n", Isa_Names[Isa]); continue; }
+
+        juce::String What = juce::String(Isa_Names[Isa]) + " matches Scalar";
+        Mako_Check(Mako_Kernels_SelfTest(k), What.toRawUTF8());
+        What = juce::String(Isa_Names[Isa]) + " table name";
+        Mako_Check(juce::String(k->Name) == Isa_Names[Isa], What.toRawUTF8());
+    }
+
+    //R1.20 2. The fallback chain on CPUs we do not have.
+    std::printf("\nFallback chain\n");
+    const unsigned All = Mako_Cpu(true, true, true);
+    const unsigned Sse = Mako_Cpu(true, false, false);
+    const unsigned NoAvx2 = Mako_Cpu(true, false, true);
+    Mako_Check(Mako_Kernels_Pick(e_IsaAuto, All) == e_IsaAVX512, "Auto, every set: AVX512");
+    Mako_Check(Mako_Kernels_Pick(e_IsaAuto, Mako_Cpu(true, true, false)) == e_IsaAVX2, "Auto, no AVX512: AVX2");
+    Mako_Check(Mako_Kernels_Pick(e_IsaAuto, Sse) == e_IsaSSE2, "Auto, SSE2 only: SSE2");
+    Mako_Check(Mako_Kernels_Pick(e_IsaAuto, Mako_Cpu(false, false, false)) == e_IsaScalar, "Auto, nothing: Scalar");
+    Mako_Check(Mako_Kernels_Pick(e_IsaAuto, NoAvx2) == e_IsaAVX512, "Auto, AVX512 without AVX2 built: AVX512");
+    Mako_Check(Mako_Kernels_Pick(e_IsaScalar, All) == e_IsaScalar, "Override Scalar, every set: Scalar");
+    Mako_Check(Mako_Kernels_Pick(e_IsaSSE2, All) == e_IsaSSE2, "Override SSE2, every set: SSE2");
+    Mako_Check(Mako_Kernels_Pick(e_IsaAVX2, All) == e_IsaAVX2, "Override AVX2, every set: AVX2");
+    Mako_Check(Mako_Kernels_Pick(e_IsaAVX512, Sse) == e_IsaSSE2, "Override AVX512, SSE2 only: SSE2");
+    Mako_Check(Mako_Kernels_Pick(e_IsaAVX2, NoAvx2) == e_IsaSSE2, "Override AVX2, no AVX2: SSE2 (never goes up)");
+    Mako_Check(Mako_Kernels_Pick(e_IsaCount, All) == e_IsaAVX512, "Unknown override (too big), every set: AVX512");
+    Mako_Check(Mako_Kernels_Pick(-3, Sse) == e_IsaSSE2, "Unknown override (negative), SSE2 only: SSE2");
+    Mako_Check(Mako_Kernels_Pick(99, Mako_Cpu(false, false, false)) == e_IsaScalar, "Unknown override, nothing: Scalar");
+
+    //R1.20 3. MAKO_SMACKTALK_ISA names.
+    std::printf("\nOverride names\n");
+    Mako_Check(Mako_Kernels_IsaFromName("scalar") == e_IsaScalar, "\"scalar\"");
+    Mako_Check(Mako_Kernels_IsaFromName("SSE2") == e_IsaSSE2, "\"SSE2\"");
+    Mako_Check(Mako_Kernels_IsaFromName(" avx2 ") == e_IsaAVX2, "\" avx2 \"");
+    Mako_Check(Mako_Kernels_IsaFromName("AvX512") == e_IsaAVX512, "\"AvX512\"");
+    Mako_Check(Mako_Kernels_IsaFromName("") == e_IsaAuto, "\"\" is Auto");
+    Mako_Check(Mako_Kernels_IsaFromName("avx1024") == e_IsaAuto, "\"avx1024\" is Auto");
+    Mako_Check(Mako_Kernels_IsaFromName("neon") == e_IsaAuto, "\"neon\" is Auto");
+
+    //R1.20 4. The real selection on this CPU. Every override gives a set the CPU can run, never a better one than asked for.
+    std::printf("\nThis CPU\n");
+    int Best = Mako_Kernels_Pick(e_IsaAuto, Available);
+    Mako_Check(Mako_Kernels_Select(e_IsaAuto) == Mako_Kernels_Table(Best), "Auto picks the best set this CPU can run");
+    Mako_Check(Mako_Kernels_Select(Mako_Kernels_IsaFromName("avx1024")) == Mako_Kernels_Table(Best), "Unknown name picks the best set");
+    for (int Isa = e_IsaScalar; Isa < e_IsaCount; Isa++)
+    {
+        const tp_kernels* k = Mako_Kernels_Select(Isa);
+        int Got = Mako_Kernels_Pick(Isa, Available);
+        juce::String What = juce::String("Override ") + Isa_Names[Isa] + " runs " + Isa_Names[Got];
+        Mako_Check((k == Mako_Kernels_Table(Got)) && (Got <= Isa) && ((Available & (1u << Got)) != 0) && Mako_Kernels_SelfTest(k), What.toRawUTF8());
+    }
+
+    const tp_kernels* Env = Mako_Kernels_Select(Mako_Kernels_EnvOverride());
+    std::printf("\nMAKO_SMACKTALK_ISA selects %s\n", Env->Name);
+
+    std::printf("%s\n", (Fails == 0) ? "PASSED" : "FAILED");
+    return (Fails == 0) ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    MakoStress.cpp
+    R2.10 Runs the WORST CASE STRESS TEST (Mako_Stress.h) and returns 1 if it
+    failed, so it can gate a release.
+
+    Build it as a Projucer Console Application: add this file and every
+    plugin .cpp file, the same JUCE modules as the plugin, and add
+    JucePlugin_Name="MakoSmackTalk" to the preprocessor definitions.
+    Build with MAKO_RT_CHECK=1 to also fail on allocations and locks.
+
+    MakoStress [-blocks n] [-seed n] [-budget-block cycles] [-budget-sample cycles]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Mako_Stress.h"
+#include <cstdio>
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI Init;
+
+    tp_stress_config Config;
+    for (int a = 1; (a + 1) < argc; a += 2)
+    {
+        juce::String Arg = argv[a], Val = argv[a + 1];
+        if (Arg == "-blocks") Config.Blocks = Val.getIntValue();
+        else if (Arg == "-seed") Config.Seed = Val.getLargeIntValue();
+        else if (Arg == "-budget-block") Config.Budget_Block = Val.getDoubleValue();
+        else if (Arg == "-budget-sample") Config.Budget_Sample = Val.getDoubleValue();
+    }
+
+    MakoBiteAudioProcessor Proc;
+    tp_stress_result Result;
+    bool Passed = Mako_Stress_Run(Proc, Config, Result);
+
+    std::printf("Blocks %d, samples %lld\n", Result.Blocks, (long long) Result.Samples);
+    std::printf("Cycles/sample: average %.1f, 99.9%% %.1f, worst %.1f\n", Result.Avg_CyclesPerSample, Result.P999_CyclesPerSample, Result.Max_CyclesPerSample);
+    std::printf("Worst block %.0f cycles\n", Result.Max_BlockCycles);
+    std::printf("Worst: %s\n", Result.Worst.toRawUTF8());
+    std::printf("Budget fails %d, NaN/Inf blocks %d, RT violations %d\n", Result.Budget_Fails, Result.NonFinite_Blocks, Result.RT_Violations);
+    if (!Passed) std::printf("First fail: %s\n", Result.First_Fail.toRawUTF8());
+    std::printf("%s\n", Passed ? "PASSED" : "FAILED");
+
+    return Passed ? 0 : 1;
+}
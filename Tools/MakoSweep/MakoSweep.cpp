@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    MakoSweep.cpp
+    R2.60 Runs the PARAMETER SWEEP RENDERER (Mako_Sweep.h) and writes one
+    CSV line per render.
+
+    Build it as a Projucer Console Application: add this file and every
+    plugin .cpp file, the same JUCE modules as the plugin, and add
+    JucePlugin_Name="MakoSmackTalk" to the preprocessor definitions.
+
+    MakoSweep [-rate hz] [-block n] [-threads n] [-random n] [-seed n]
+              [-sense a,b,..] [-q a,b,..] [-gain a,b,..] [-modes a,b,..]
+              [-audio dir] [-out sweep.csv] file.wav ...
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Mako_Sweep.h"
+#include <cstdio>
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI Init;
+
+    tp_sweep_config Config;
+    juce::File Csv = juce::File::getCurrentWorkingDirectory().getChildFile("sweep.csv");
+
+    //R2.60 A comma list of values, for example -sense .2,.4,.6
+    auto Floats = [](const juce::String& List)
+    {
+        juce::Array<float> Values;
+        for (const auto& v : juce::StringArray::fromTokens(List, ",", ""))
+            if (v.trim().isNotEmpty()) Values.add(v.getFloatValue());
+        return Values;
+    };
+
+    for (int a = 1; a < argc; a++)
+    {
+        juce::String Arg = argv[a];
+        bool HasVal = (a + 1) < argc;
+
+        if ((Arg == "-rate") && HasVal) Config.SampleRate = juce::String(argv[++a]).getDoubleValue();
+        else if ((Arg == "-block") && HasVal) Config.BlockSize = juce::String(argv[++a]).getIntValue();
+        else if ((Arg == "-threads") && HasVal) Config.Threads = juce::String(argv[++a]).getIntValue();
+        else if ((Arg == "-random") && HasVal) Config.Random = juce::String(argv[++a]).getIntValue();
+        else if ((Arg == "-seed") && HasVal) Config.Seed = juce::String(argv[++a]).getLargeIntValue();
+        else if ((Arg == "-sense") && HasVal) Config.Sense = Floats(argv[++a]);
+        else if ((Arg == "-q") && HasVal) Config.Q = Floats(argv[++a]);
+        else if ((Arg == "-gain") && HasVal) Config.Gain = Floats(argv[++a]);
+        else if ((Arg == "-modes") && HasVal)
+        {
+            Config.Modes.clear();
+            for (float m : Floats(argv[++a])) Config.Modes.add(int(m));
+        }
+        else if ((Arg == "-audio") && HasVal) Config.Audio_Dir = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++a]);
+        else if ((Arg == "-out") && HasVal) Csv = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++a]);
+        else Config.Files.add(juce::File::getCurrentWorkingDirectory().getChildFile(Arg));
+    }
+
+    tp_sweep_result Result;
+    if (!Mako_Sweep_Run(Config, Result))
+    {
+        std::printf("No input files could be read.\n");
+        return 1;
+    }
+
+    if (!Mako_Sweep_Write(Result, Csv))
+    {
+        std::printf("Could not write %s\n", Csv.getFullPathName().toRawUTF8());
+        return 1;
+    }
+
+    std::printf("%d renders (%d points x %d files) on %d threads in %.1f seconds\n", int(Result.Renders.size()),
+                int(Result.Points.size()), Result.Items.size(), Result.Threads, Result.Seconds);
+    std::printf("Summary: %s\n", Csv.getFullPathName().toRawUTF8());
+
+    return 0;
+}
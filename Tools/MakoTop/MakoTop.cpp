@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+
+    MakoTop.cpp
+    R2.00 TELEMETRY reader. Shows every running SmackTalk instance in a live
+    table, like the unix top command. See Mako_Telemetry.h.
+
+    Plain C++17, no JUCE. Build from the repo folder:
+      g++ -std=c++17 -O2 -I. Tools/MakoTop/MakoTop.cpp -o makotop
+      cl /std:c++17 /EHsc /O2 /I. Tools\MakoTop\MakoTop.cpp
+
+    makotop [-i ms] [-h percent] [-1]
+      -i  Refresh time in ms (default 1000).
+      -h  CPU % of one core (for one instance) that counts as HOT (default 2).
+      -1  Print the table once and quit (for scripts).
+
+  ==============================================================================
+*/
+
+#include "Mako_Telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+ #define WIN32_LEAN_AND_MEAN
+ #define NOMINMAX
+ #include <windows.h>
+#else
+ #include <cerrno>
+ #include <fcntl.h>
+ #include <signal.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#endif
+
+using namespace MakoTelemetry;
+
+namespace
+{
+    const char* const Mode_Names[] = { "Smack", "Talk", "Vox", "Track" };
+    const char* const Tier_Names[] = { "Eco", "Std", "High" };
+
+    //R2.00 What we remember about each slot between screens.
+    struct tp_row
+    {
+        int Slot;
+        uint32_t Pid;
+        tp_telemetry_data Data;
+        float Cpu;          //R2.00 Percent of one core.
+        bool Active;        //R2.00 Processed audio since the last screen.
+        bool Clipped;       //R2.00 Clipped since the last screen.
+    };
+
+    struct tp_last
+    {
+        uint32_t Pid = 0;
+        uint64_t Blocks = 0;
+        uint32_t Clips = 0;
+    };
+
+    //R2.00 Same place the plugin uses (MakoTelemetryPublisher::Mako_Telemetry_File).
+    std::string Mako_Segment_Path()
+    {
+       #if defined(_WIN32)
+        char Temp[MAX_PATH + 1] = {};
+        GetTempPathA(MAX_PATH, Temp);
+        return std::string(Temp) + Segment_Name;
+       #else
+        std::string Dir = Segment_Folder(false);
+        return Dir.empty() ? std::string() : (Dir + "/" + Segment_Name);
+       #endif
+    }
+
+    //R2.00 Map the file read only. Returns nullptr if no instance has made it yet.
+    const tp_telemetry_segment* Mako_Segment_Open(const std::string& Path)
+    {
+        const size_t Size = sizeof(tp_telemetry_segment);
+
+       #if defined(_WIN32)
+        HANDLE f = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                               nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (f == INVALID_HANDLE_VALUE) return nullptr;
+
+        LARGE_INTEGER Len = {};
+        GetFileSizeEx(f, &Len);
+        HANDLE m = (size_t(Len.QuadPart) < Size) ? nullptr : CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(f);
+        if (m == nullptr) return nullptr;
+
+        void* p = MapViewOfFile(m, FILE_MAP_READ, 0, 0, Size);
+        CloseHandle(m);
+        return static_cast<const tp_telemetry_segment*>(p);
+       #else
+        int fd = open(Path.c_str(), O_RDONLY | O_NOFOLLOW);
+        if (fd < 0) return nullptr;
+
+        struct stat st = {};
+        void* p = MAP_FAILED;
+        if ((fstat(fd, &st) == 0) && (Size <= size_t(st.st_size)))
+            p = mmap(nullptr, Size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        return (p == MAP_FAILED) ? nullptr : static_cast<const tp_telemetry_segment*>(p);
+       #endif
+    }
+
+    //R2.00 Slots left behind by a host that crashed are not shown. The next new instance takes them over.
+    bool Mako_Process_Alive(uint32_t Id)
+    {
+       #if defined(_WIN32)
+        HANDLE h = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, DWORD(Id));
+        if (h == nullptr) return (GetLastError() == ERROR_ACCESS_DENIED);
+        DWORD Code = 0;
+        bool Alive = (GetExitCodeProcess(h, &Code) != 0) && (Code == STILL_ACTIVE);
+        CloseHandle(h);
+        return Alive;
+       #else
+        return (kill(pid_t(Id), 0) == 0) || (errno == EPERM);
+       #endif
+    }
+
+    std::string Mako_Db(float Peak)
+    {
+        char s[16];
+        if (Peak <= 1.0e-6f) return "-inf";
+        std::snprintf(s, sizeof(s), "%.1f", 20.0f * std::log10(Peak));
+        return s;
+    }
+
+    std::string Mako_Gate(float Gate)
+    {
+        char s[16];
+        if (Gate < 0.0f) return "off";
+        std::snprintf(s, sizeof(s), "%3d%%", int(Gate * 100.0f + .5f));
+        return s;
+    }
+
+    template <typename T> const char* Mako_Name(const T& Names, int i)
+    {
+        const int Count = int(sizeof(Names) / sizeof(Names[0]));
+        return ((0 <= i) && (i < Count)) ? Names[i] : "?";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int Interval = 1000;
+    float Hot = 2.0f;
+    bool Once = false;
+
+    for (int a = 1; a < argc; a++)
+    {
+        std::string Arg = argv[a];
+        if ((Arg == "-i") && ((a + 1) < argc)) Interval = std::max(50, std::atoi(argv[++a]));
+        else if ((Arg == "-h") && ((a + 1) < argc)) Hot = float(std::atof(argv[++a]));
+        else if (Arg == "-1") Once = true;
+        else
+        {
+            std::printf("usage: makotop [-i ms] [-h percent] [-1]\n");
+            return 1;
+        }
+    }
+
+   #if defined(_WIN32)
+    //R2.00 Let the Windows console understand the clear screen codes.
+    HANDLE Out = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD ConMode = 0;
+    if (GetConsoleMode(Out, &ConMode)) SetConsoleMode(Out, ConMode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+   #endif
+
+    const std::string Path = Mako_Segment_Path();
+    if (Path.empty())
+    {
+        //R2.00 Someone else owns our folder (or can write in it). Do not read from it.
+        std::printf("MakoTop - the telemetry folder is not safe to use\n");
+        return 1;
+    }
+
+    const tp_telemetry_segment* Seg = nullptr;
+    std::vector<tp_last> Last(Slot_Count);
+    bool First = true;
+
+    for (;;)
+    {
+        if (Seg == nullptr) Seg = Mako_Segment_Open(Path);
+
+        std::vector<tp_row> Rows;
+        bool Valid = (Seg != nullptr) && (Seg->Header.Magic.load() == Magic) && (Seg->Header.Version == Telemetry_Version);
+
+        for (int i = 0; Valid && (i < Slot_Count); i++)
+        {
+            const tp_telemetry_slot& s = Seg->Slots[i];
+            tp_row r = {};
+            r.Slot = i;
+            r.Pid = s.Owner.load();
+            if ((r.Pid == 0) || !Mako_Process_Alive(r.Pid)) continue;
+
+            //R2.00 The writer only holds Seq odd for a few ns. If it keeps failing the slot is being reset, skip it.
+            bool Got = false;
+            for (int Try = 0; (Try < 100) && !Got; Try++) Got = Mako_Telemetry_Read(s, r.Data);
+            if (!Got) continue;
+
+            //R2.00 A new owner starts a new history.
+            tp_last& l = Last[size_t(i)];
+            if (l.Pid != r.Pid) l = tp_last { r.Pid, r.Data.Blocks, r.Data.Clips };
+
+            double BlockNs = (0.0f < r.Data.SampleRate) ? 1.0e9 * double(r.Data.BlockSize) / double(r.Data.SampleRate) : 0.0;
+            r.Cpu = (0.0 < BlockNs) ? float(100.0 * double(r.Data.Block_Ns) / BlockNs) : 0.0f;
+            r.Active = First ? (0 < r.Data.Blocks) : (r.Data.Blocks != l.Blocks);
+            r.Clipped = First ? (0 < r.Data.Clips) : (r.Data.Clips != l.Clips);
+            if (!r.Active) r.Cpu = 0.0f;
+
+            l.Blocks = r.Data.Blocks;
+            l.Clips = r.Data.Clips;
+            Rows.push_back(r);
+        }
+
+        //R2.00 Hottest first, idle ones at the bottom.
+        std::sort(Rows.begin(), Rows.end(), [](const tp_row& a, const tp_row& b)
+        {
+            if (a.Active != b.Active) return a.Active;
+            if (a.Cpu != b.Cpu) return b.Cpu < a.Cpu;
+            return a.Slot < b.Slot;
+        });
+
+        float Total = 0.0f;
+        int Active = 0, Clipping = 0;
+        for (const tp_row& r : Rows)
+        {
+            Total += r.Cpu;
+            if (r.Active) Active++;
+            if (r.Clipped) Clipping++;
+        }
+
+        if (!Once) std::printf("\x1b[H\x1b[2J");
+        if (!Valid)
+            std::printf("MakoTop - waiting for a SmackTalk instance (%s)\n", Path.c_str());
+        else
+        {
+            std::printf("MakoTop - %d instances, %d active, %d clipping, total CPU %.1f%% of one core\n\n",
+                        int(Rows.size()), Active, Clipping, Total);
+            std::printf("%4s %7s %-5s %-4s %6s %5s %6s %9s %9s %6s %5s %6s %6s  %s\n",
+                        "SLOT", "PID", "MODE", "QUAL", "RATE", "BLOCK", "CPU%", "NS/BLK", "MAX NS", "ENV", "GATE", "PEAK", "CLIPS", "STATE");
+
+            for (const tp_row& r : Rows)
+            {
+                const tp_telemetry_data& d = r.Data;
+                std::string State = !r.Active ? "IDLE" : ((Hot <= r.Cpu) ? "HOT" : "ok");
+                if (r.Clipped) State += " CLIP";
+
+                std::printf("%4d %7u %-5s %-4s %6.0f %5d %6.2f %9.0f %9.0f %6.3f %5s %6s %6u  %s\n",
+                            r.Slot, r.Pid, Mako_Name(Mode_Names, d.Mode), Mako_Name(Tier_Names, d.Tier),
+                            double(d.SampleRate), d.BlockSize, double(r.Cpu), double(d.Block_Ns), double(d.Block_Ns_Max),
+                            double(d.Envelope), Mako_Gate(d.Gate).c_str(), Mako_Db(d.Peak_Out).c_str(), d.Clips, State.c_str());
+            }
+        }
+        std::fflush(stdout);
+
+        if (Once) break;
+        First = false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(Interval));
+    }
+
+    return 0;
+}